@@ -56,6 +56,11 @@ if(HAVE_ZFRAME_META)
     add_definitions(-DHAVE_ZFRAME_META)
 endif(HAVE_ZFRAME_META)
 
+check_function_exists(zframe_frommem HAVE_ZFRAME_FROMMEM)
+if(HAVE_ZFRAME_FROMMEM)
+    add_definitions(-DHAVE_ZFRAME_FROMMEM)
+endif(HAVE_ZFRAME_FROMMEM)
+
 # check signature of zmsg_encode()
 check_cxx_source_compiles("
 #include <zmq.h>
@@ -6,7 +6,7 @@
 %global user_module_dir %{mydatarootdir}/qore-modules/
 
 Name:           qore-zmq-module
-Version:        1.0.2
+Version:        1.1.0
 Release:        1
 Summary:        Qorus Integration Engine - Qore zmq module
 License:        MIT
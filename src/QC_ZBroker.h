@@ -0,0 +1,164 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QC_ZBroker.h defines the c++ implementation of the ZBroker class */
+/*
+    QC_ZBroker.h
+
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_ZMQ_QC_ZBROKER_H
+
+#define _QORE_ZMQ_QC_ZBROKER_H
+
+#include "zmq-module.h"
+
+#include "QC_ZSocketRouter.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+// worker signals; sent as a single frame after the worker identity (Paranoid Pirate protocol)
+#define ZBROKER_READY '\001'
+#define ZBROKER_HEARTBEAT '\002'
+
+// default option values
+#define ZBROKER_DEFAULT_HEARTBEAT_INTERVAL 1000
+#define ZBROKER_DEFAULT_LIVENESS 3
+
+// the maximum number of messages routed from one socket before the other sockets and timers are serviced
+#define ZBROKER_BATCH 256
+
+// runs a load-balancing broker between a frontend and a backend ROUTER socket in a native thread owned by the
+// module; requests are routed to the least recently used ready worker
+class QoreZBroker : public AbstractPrivateData {
+public:
+    // takes ownership of the references to the sockets
+    DLLLOCAL QoreZBroker(QoreZContext& ctx, QoreRouterZSock* frontend, QoreRouterZSock* backend,
+        const QoreHashNode* opts, ExceptionSink* xsink);
+
+    // starts the broker thread
+    DLLLOCAL int start(ExceptionSink* xsink);
+
+    // terminates the broker and waits for the thread to exit
+    DLLLOCAL int stop(ExceptionSink* xsink);
+
+    // waits for the thread to exit
+    DLLLOCAL void join();
+
+    // returns a ZmqBrokerStatistics hash; can be called while the broker is running
+    DLLLOCAL QoreHashNode* getStatistics(ExceptionSink* xsink) const;
+
+    // returns the errno value that terminated the broker or 0 if it was stopped with stop()
+    DLLLOCAL int getErrno() const {
+        return broker_errno;
+    }
+
+    DLLLOCAL bool isRunning() const {
+        return running;
+    }
+
+    DLLLOCAL virtual void deref(ExceptionSink* xsink);
+
+protected:
+    DLLLOCAL virtual ~QoreZBroker();
+
+private:
+    struct Worker {
+        // the worker's routing identity on the backend socket
+        std::string id;
+        // the time in ms after which the worker is considered dead if nothing has been received from it
+        int64 expiry;
+    };
+    typedef std::list<Worker> worker_list_t;
+
+    QoreRouterZSock* frontend;
+    QoreRouterZSock* backend;
+    // the broker's control socket, used by the native thread
+    void* control = nullptr;
+    // the socket used to send commands to the broker
+    void* commander = nullptr;
+
+    // the interval in ms for heartbeats sent to ready workers
+    int64 heartbeat_interval;
+    // the number of heartbeat intervals without a message after which a ready worker is removed
+    int64 liveness;
+
+    // ready workers; the front is the least recently used worker; only used by the broker thread
+    worker_list_t workers;
+    // ready workers by identity; only used by the broker thread
+    std::unordered_map<std::string, worker_list_t::iterator> worker_map;
+
+    std::thread thread;
+    // serializes access to the commander socket and the thread state
+    std::mutex m;
+    // signaled when the broker thread exits
+    std::condition_variable cond;
+    std::atomic<bool> running{false};
+    bool started = false;
+    // the broker's result: 0 = stopped, otherwise the errno value
+    int broker_errno = 0;
+
+    // counters; updated by the broker thread and read by Qore threads
+    std::atomic<int64> requests{0};
+    std::atomic<int64> replies{0};
+    std::atomic<int64> ready_workers{0};
+    std::atomic<int64> registrations{0};
+    std::atomic<int64> heartbeats_in{0};
+    std::atomic<int64> heartbeats_out{0};
+    std::atomic<int64> expired{0};
+
+    // the native thread function
+    DLLLOCAL void run();
+
+    // routes a request from the frontend to the least recently used worker; returns 1 if a request was routed, 0 if
+    // no message is queued and -1 for error (errno set)
+    DLLLOCAL int routeRequest();
+
+    // processes a message from a worker and routes replies to the frontend; returns 1 if a message was processed, 0
+    // if no message is queued and -1 for error (errno set)
+    DLLLOCAL int routeReply(int64 now);
+
+    // sends a heartbeat to all ready workers; returns -1 for error (errno set)
+    DLLLOCAL int sendHeartbeats();
+
+    // adds the worker to the back of the ready queue and resets its expiry time
+    DLLLOCAL void workerReady(std::string&& id, int64 now);
+
+    // removes ready workers that have expired
+    DLLLOCAL void purge(int64 now);
+
+    // waits for the thread to exit and releases the sockets back to Qore; must be called with the lock held
+    DLLLOCAL void joinIntern(std::unique_lock<std::mutex>& lck);
+
+    // sets or clears native ownership of the sockets
+    DLLLOCAL void setSocketsNativeOwned(bool owned) {
+        frontend->setNativeOwned(owned);
+        backend->setNativeOwned(owned);
+    }
+};
+
+DLLLOCAL extern QoreClass* QC_ZBROKER;
+DLLLOCAL extern qore_classid_t CID_ZBROKER;
+
+#endif // _QORE_ZMQ_QC_ZBROKER_H
@@ -28,12 +28,34 @@
 
 #include "zmq-module.h"
 
+// placeholder values for context options not supported by the libzmq version; setting them will fail with EINVAL
+#ifndef QORE_HAVE_ZMQ_THREAD_OPTIONS
+#ifndef ZMQ_THREAD_PRIORITY
+#define ZMQ_THREAD_PRIORITY -1
+#endif
+#ifndef ZMQ_THREAD_SCHED_POLICY
+#define ZMQ_THREAD_SCHED_POLICY -1
+#endif
+#ifndef ZMQ_THREAD_AFFINITY_CPU_ADD
+#define ZMQ_THREAD_AFFINITY_CPU_ADD -1
+#endif
+#ifndef ZMQ_THREAD_AFFINITY_CPU_REMOVE
+#define ZMQ_THREAD_AFFINITY_CPU_REMOVE -1
+#endif
+#ifndef ZMQ_THREAD_NAME_PREFIX
+#define ZMQ_THREAD_NAME_PREFIX -1
+#endif
+#endif
+
 class QoreZContext : public AbstractPrivateData {
 public:
     // creates the object
     DLLLOCAL QoreZContext() : ctx(zmq_ctx_new()) {
     }
 
+    // applies the options in a ZmqContextOptions hash; must be called before any sockets are created
+    DLLLOCAL int setOptions(const QoreHashNode* opts, ExceptionSink* xsink);
+
     DLLLOCAL void* operator*() {
         return ctx;
     }
@@ -40,6 +40,10 @@ public:
    DLLLOCAL QoreZFrame(const void* data, size_t size) : frame(zframe_new(data, size)) {
    }
 
+   // creates a frame referencing the buffer of the given string or binary value without copying it, if supported by
+   // the czmq library, otherwise the data is copied
+   DLLLOCAL QoreZFrame(const SimpleQoreNode* n, const void* data, size_t size);
+
    //! creates a frame from a zframe_t ptr
    DLLLOCAL QoreZFrame(zframe_t* frame) : frame(frame) {
    }
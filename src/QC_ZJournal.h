@@ -0,0 +1,217 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QC_ZJournal.h defines the c++ implementation of the ZJournal class */
+/*
+    QC_ZJournal.h
+
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_ZMQ_QC_ZJOURNAL_H
+
+#define _QORE_ZMQ_QC_ZJOURNAL_H
+
+#include "zmq-module.h"
+
+#include "QC_ZSocket.h"
+#include "QC_ZMsg.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// the journal segment file magic value
+#define ZJOURNAL_MAGIC "QZJ\x01"
+// the journal segment file format version
+#define ZJOURNAL_VERSION 1
+// the size of the segment file header: magic, version and segment number
+#define ZJOURNAL_HEADER_SIZE 16
+// the file name suffix for journal segments
+#define ZJOURNAL_SUFFIX ".zj"
+
+// sync policies
+#define ZJOURNAL_SYNC_NONE 0
+#define ZJOURNAL_SYNC_SEGMENT 1
+#define ZJOURNAL_SYNC_BATCH 2
+#define ZJOURNAL_SYNC_ALWAYS 3
+
+// default option values
+#define ZJOURNAL_DEFAULT_PREFIX "journal"
+#define ZJOURNAL_DEFAULT_SEGMENT_SIZE (64ll * 1024 * 1024)
+#define ZJOURNAL_DEFAULT_BATCH_SIZE 1000
+
+// the maximum size of the write buffer before it is written regardless of the batch size
+#define ZJOURNAL_MAX_BUFFER (4 * 1024 * 1024)
+
+// the interval in which the capture thread checks if it should stop
+#define ZJOURNAL_POLL_MS 100
+
+// a read-only memory mapping of a journal segment file
+class ZJournalSegmentMap {
+public:
+    DLLLOCAL ZJournalSegmentMap() {
+    }
+
+    DLLLOCAL ~ZJournalSegmentMap();
+
+    // maps the file and validates the header; returns -1 for error (exception raised)
+    DLLLOCAL int open(const char* path, const char* err, ExceptionSink* xsink);
+
+    // positions the iterator on the next record and returns its frame count; returns 0 at the end of the segment
+    // (an incomplete final record is ignored) and -1 for an invalid record (exception raised)
+    DLLLOCAL int64 next(const char* err, ExceptionSink* xsink);
+
+    // returns the next frame of the current record
+    DLLLOCAL void getFrame(const unsigned char*& data, size_t& len);
+
+private:
+    int fd = -1;
+    unsigned char* map = nullptr;
+    size_t size = 0;
+    // the offset of the next record
+    size_t pos = ZJOURNAL_HEADER_SIZE;
+    // the offset of the next frame in the current record
+    size_t frame_pos = 0;
+    std::string path;
+};
+
+// an append-only journal of messages stored in segment files
+class QoreZJournal : public AbstractPrivateData {
+public:
+    DLLLOCAL QoreZJournal(const char* dir, const QoreHashNode* opts, ExceptionSink* xsink);
+
+    // appends a message; returns -1 for error (exception raised)
+    DLLLOCAL int append(const zmsg_t* msg, ExceptionSink* xsink);
+
+    // appends a message from a list of string and binary values; returns -1 for error (exception raised)
+    DLLLOCAL int append(const QoreListNode* l, ExceptionSink* xsink);
+
+    // writes all buffered messages to the current segment; returns -1 for error (exception raised)
+    DLLLOCAL int flush(bool sync, ExceptionSink* xsink);
+
+    // closes the journal; returns -1 for error (exception raised)
+    DLLLOCAL int close(ExceptionSink* xsink);
+
+    // returns the paths of all segment files in the journal's directory in order
+    DLLLOCAL QoreListNode* getSegments(ExceptionSink* xsink) const;
+
+    DLLLOCAL int64 getCount() const {
+        return count;
+    }
+
+    // starts capturing messages received on an internal socket bound to the returned endpoint
+    DLLLOCAL int startCapture(QoreZContext& ctx, std::string& endpoint, ExceptionSink* xsink);
+
+    // stops the capture thread; returns -1 if an error occurred appending captured messages (exception raised)
+    DLLLOCAL int stopCapture(ExceptionSink* xsink);
+
+    // returns true if the capture thread is running and appending messages to the journal
+    DLLLOCAL bool isCapturing() const {
+        return capture_running && !capture_errno;
+    }
+
+    // returns the number of captured messages discarded after an error in the current or last capture
+    DLLLOCAL int64 getCaptureDiscarded() const {
+        return capture_discarded;
+    }
+
+    // replays all messages in the given segment file on the socket; returns the number of messages sent or -1 for
+    // error (exception raised)
+    DLLLOCAL static int64 replay(const char* path, QoreZSock& zsock, ExceptionSink* xsink);
+
+    // returns a list of ZMsg objects for all messages in the given segment file
+    DLLLOCAL static QoreListNode* load(const char* path, ExceptionSink* xsink);
+
+protected:
+    DLLLOCAL virtual ~QoreZJournal();
+
+private:
+    std::string dir;
+    std::string prefix;
+    int64 segment_size;
+    int64 batch_size;
+    int sync_policy;
+
+    // serializes access to the journal from Qore threads and the capture thread
+    mutable std::mutex m;
+    // the file descriptor of the current segment
+    int fd = -1;
+    // the number of the current segment
+    int64 seq = 0;
+    // set when the journal has been closed
+    bool closed = false;
+    // the number of bytes written to or buffered for the current segment
+    int64 seg_bytes = 0;
+    // records not yet written to the current segment
+    std::string buf;
+    // the number of records in the buffer
+    int64 buf_count = 0;
+    // the total number of messages appended
+    std::atomic<int64> count{0};
+
+    // serializes starting and stopping the capture thread; never acquired by the capture thread
+    std::mutex capture_m;
+    // the capture socket; owned and closed by the capture thread once started
+    void* capture_sock = nullptr;
+    std::thread capture_thread;
+    std::atomic<bool> capture_running{false};
+    std::atomic<bool> capture_stop{false};
+    // an errno value if appending a captured message failed; further captured messages are discarded
+    std::atomic<int> capture_errno{0};
+    // the number of captured messages discarded after an error
+    std::atomic<int64> capture_discarded{0};
+
+    // opens the next segment; returns 0 or an errno value; the lock must be held
+    DLLLOCAL int openSegment();
+
+    // closes the current segment; returns 0 or an errno value; the lock must be held
+    DLLLOCAL int closeSegment();
+
+    // starts a new record of the given size, switching to a new segment if necessary; returns 0 or an errno
+    // value; the lock must be held
+    DLLLOCAL int beginRecord(size_t rec_size);
+
+    // completes the record appended to the buffer and writes the buffer according to the batch size and sync
+    // policy; returns 0 or an errno value; the lock must be held
+    DLLLOCAL int endRecord();
+
+    // writes the buffer to the current segment; returns 0 or an errno value; the lock must be held
+    DLLLOCAL int writeBuffer(bool sync);
+
+    // appends a message; returns 0 or an errno value; the lock must be held
+    DLLLOCAL int appendIntern(const zmsg_t* msg);
+
+    // the capture thread function
+    DLLLOCAL void runCapture();
+
+    // stops the capture thread; capture_m must be held
+    DLLLOCAL int stopCaptureIntern(ExceptionSink* xsink);
+
+    // returns the path of the given segment
+    DLLLOCAL std::string getSegmentPath(int64 n) const;
+
+    // returns the numbers of all segments in the directory in order
+    DLLLOCAL int getSegmentNumbers(std::vector<int64>& segs) const;
+};
+
+DLLLOCAL extern QoreClass* QC_ZJOURNAL;
+DLLLOCAL extern qore_classid_t CID_ZJOURNAL;
+
+#endif // _QORE_ZMQ_QC_ZJOURNAL_H
@@ -0,0 +1,160 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QC_ZLoop.h defines the c++ implementation of the ZLoop class */
+/*
+    QC_ZLoop.h
+
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_ZMQ_QC_ZLOOP_H
+
+#define _QORE_ZMQ_QC_ZLOOP_H
+
+#include "zmq-module.h"
+
+#include "QC_ZPoller.h"
+
+#include <chrono>
+#include <map>
+#include <vector>
+
+// a timer registered with a ZLoop
+struct ZLoopTimer {
+    int64 id;
+    // the next expiry time in microseconds on the steady clock
+    int64 deadline;
+    // the timer interval in milliseconds
+    int64 interval;
+    // the number of remaining expirations; 0 = unlimited
+    int64 times;
+    ResolvedCallReferenceNode* code;
+    bool cancelled = false;
+
+    DLLLOCAL ZLoopTimer(int64 id, int64 deadline, int64 interval, int64 times, ResolvedCallReferenceNode* code)
+        : id(id), deadline(deadline), interval(interval), times(times), code(code) {
+    }
+};
+
+// orders the timer heap so that the timer with the earliest deadline is at the front
+struct ZLoopTimerCmp {
+    DLLLOCAL bool operator()(const ZLoopTimer* a, const ZLoopTimer* b) const {
+        return a->deadline == b->deadline ? a->id > b->id : a->deadline > b->deadline;
+    }
+};
+
+class QoreZLoop : public AbstractZmqThreadLocalData {
+public:
+    // registers a socket handler; takes ownership of the references to obj, zsock and code
+    DLLLOCAL void addSocket(QoreObject* obj, QoreZSock* zsock, short events, ResolvedCallReferenceNode* code) {
+        pset.addSocket(obj, zsock, events);
+        handlers.push_back(code);
+        changed = true;
+    }
+
+    // registers a file descriptor handler; takes ownership of the reference to code
+    DLLLOCAL void addFd(int fd, short events, ResolvedCallReferenceNode* code) {
+        pset.addFd(fd, events);
+        handlers.push_back(code);
+        changed = true;
+    }
+
+    // removes the handler for the given item
+    DLLLOCAL void remove(size_t i, ExceptionSink* xsink) {
+        pset.remove(i, xsink);
+        handlers[i]->deref(xsink);
+        handlers.erase(handlers.begin() + i);
+        changed = true;
+    }
+
+    DLLLOCAL ZmqPollSet& getPollSet() {
+        return pset;
+    }
+
+    // registers a timer; takes ownership of the reference to code; returns the timer ID
+    DLLLOCAL int64 addTimer(int64 delay_ms, int64 times, ResolvedCallReferenceNode* code);
+
+    // cancels a timer; returns true if the timer was found
+    DLLLOCAL bool removeTimer(int64 id, ExceptionSink* xsink);
+
+    // runs the reactor until stopped, a handler returns False, nothing is registered, or an exception is raised
+    DLLLOCAL int run(ExceptionSink* xsink);
+
+    DLLLOCAL void stop() {
+        stop_requested = true;
+    }
+
+    DLLLOCAL bool isRunning() const {
+        return running;
+    }
+
+    DLLLOCAL size_t getTimerCount() const {
+        return timer_map.size();
+    }
+
+    // removes all handlers and timers
+    DLLLOCAL void clear(ExceptionSink* xsink);
+
+    DLLLOCAL virtual void deref(ExceptionSink* xsink) {
+        if (ROdereference()) {
+            clear(xsink);
+            delete this;
+        }
+    }
+
+    //! the error string for exceptions
+    DLLLOCAL virtual const char* getErrorString() const {
+        return "ZLOOP-THREAD-ERROR";
+    }
+
+    // returns the current time in microseconds on the steady clock
+    DLLLOCAL static int64 now() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    ZmqPollSet pset;
+    // handlers for each poll item
+    std::vector<ResolvedCallReferenceNode*> handlers;
+    // timer heap with lazy removal of cancelled timers
+    std::vector<ZLoopTimer*> timer_heap;
+    // active timers by ID
+    std::map<int64, ZLoopTimer*> timer_map;
+    // expired timers being fired; reused to avoid allocations
+    std::vector<ZLoopTimer*> fired;
+    int64 timer_seq = 0;
+    // set when poll items are added or removed while handlers are dispatched
+    bool changed = false;
+    bool stop_requested = false;
+    bool running = false;
+
+    // calls a handler; returns -1 if the loop should stop
+    DLLLOCAL int callHandler(ResolvedCallReferenceNode* code, QoreListNode* args, ExceptionSink* xsink);
+
+    // fires all expired timers; returns -1 if the loop should stop
+    DLLLOCAL int runTimers(ExceptionSink* xsink);
+
+    // returns the poll timeout in ms until the next timer expires or -1 if there are no timers
+    DLLLOCAL long getPollTimeout();
+};
+
+DLLLOCAL extern QoreClass* QC_ZLOOP;
+DLLLOCAL extern qore_classid_t CID_ZLOOP;
+
+#endif // _QORE_ZMQ_QC_ZLOOP_H
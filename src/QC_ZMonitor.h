@@ -0,0 +1,142 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QC_ZMonitor.h defines the c++ implementation of the ZMonitor class */
+/*
+    QC_ZMonitor.h
+
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_ZMQ_QC_ZMONITOR_H
+
+#define _QORE_ZMQ_QC_ZMONITOR_H
+
+#include "zmq-module.h"
+
+#include "QC_ZSocket.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// the number of distinct monitor event types; each event is a single bit in a 16-bit mask
+#define ZMONITOR_EVENT_TYPES 16
+
+// the interval in which the monitor thread checks if it should stop
+#define ZMONITOR_POLL_MS 100
+
+// a decoded socket monitor event
+struct ZMonitorEvent {
+    int event;
+    int64 value;
+    std::string endpoint;
+};
+
+// decodes socket monitor events in a native thread
+class QoreZMonitor : public AbstractPrivateData {
+public:
+    // starts monitoring the given socket and takes ownership of the reference; must be called in the socket's
+    // thread
+    DLLLOCAL QoreZMonitor(QoreZContext& ctx, QoreZSock* zsock, int events, size_t queue_size,
+        ExceptionSink* xsink);
+
+    // returns the next event or nullptr if no event arrives before the timeout expires
+    DLLLOCAL QoreHashNode* getEvent(int64 timeout_ms, ExceptionSink* xsink);
+
+    // returns up to max events without waiting; max < 0 means all queued events
+    DLLLOCAL QoreListNode* getEvents(int64 max, ExceptionSink* xsink);
+
+    // returns a hash of event counts by event name
+    DLLLOCAL QoreHashNode* getCounters(ExceptionSink* xsink) const;
+
+    // returns the count for a single event type
+    DLLLOCAL int64 getCount(int event) const;
+
+    DLLLOCAL int64 getPeerCount() const {
+        return peers;
+    }
+
+    DLLLOCAL int64 getDropped() const {
+        return dropped;
+    }
+
+    DLLLOCAL bool isRunning() const {
+        return running;
+    }
+
+    // unregisters the monitor from the socket and stops the monitor thread; returns 0 for OK, -1 for error
+    // (exception raised: the socket cannot be accessed from the current thread)
+    DLLLOCAL int stop(ExceptionSink* xsink);
+
+    DLLLOCAL virtual void deref(ExceptionSink* xsink);
+
+    // returns the name of the given event
+    DLLLOCAL static const char* getEventName(int event);
+
+protected:
+    DLLLOCAL virtual ~QoreZMonitor();
+
+private:
+    // the monitored socket; the reference is released when the monitor is unregistered
+    QoreZSock* zsock;
+    // the socket receiving events from the monitored socket; owned and closed by the monitor thread once started
+    void* pair = nullptr;
+    std::thread thread;
+    // serializes stopping the thread
+    std::mutex stop_m;
+
+    // protects the event queue
+    mutable std::mutex m;
+    // signaled when events are queued or the thread exits
+    std::condition_variable cond;
+    std::deque<ZMonitorEvent> queue;
+    size_t queue_size;
+
+    std::atomic<int64> counters[ZMONITOR_EVENT_TYPES];
+    // the number of connected peers
+    std::atomic<int64> peers{0};
+    // the number of events dropped because the queue was full
+    std::atomic<int64> dropped{0};
+    std::atomic<bool> running{false};
+    std::atomic<bool> stop_requested{false};
+    // true while the monitor is registered with the socket
+    bool monitoring = false;
+
+    // the native thread function
+    DLLLOCAL void run();
+
+    // unregisters the monitor from the socket; must be called with stop_m held; returns 0 for OK, -1 for error
+    // (exception raised: the socket cannot be accessed from the current thread)
+    DLLLOCAL int unregisterIntern(ExceptionSink* xsink);
+
+    // stops and joins the monitor thread; must be called with stop_m held
+    DLLLOCAL void stopThreadIntern();
+
+    // processes a single event
+    DLLLOCAL void processEvent(ZMonitorEvent&& ev);
+
+    DLLLOCAL static QoreHashNode* makeEventHash(const ZMonitorEvent& ev, ExceptionSink* xsink);
+};
+
+DLLLOCAL extern QoreClass* QC_ZMONITOR;
+DLLLOCAL extern qore_classid_t CID_ZMONITOR;
+
+#endif // _QORE_ZMQ_QC_ZMONITOR_H
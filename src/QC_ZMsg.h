@@ -30,6 +30,8 @@
 
 #include <czmq.h>
 
+#include <vector>
+
 class QoreZMsg : public AbstractZmqThreadLocalData {
 public:
     // creates an empty msg
@@ -43,7 +45,9 @@ public:
     DLLLOCAL QoreZMsg(const QoreZMsg& old) : msg(zmsg_dup(old.msg)) {
     }
 
+    // returns the message; the frame index is invalidated as the caller may modify the message
     DLLLOCAL zmsg_t* operator*() {
+        index_valid = false;
         return msg;
     }
 
@@ -54,9 +58,29 @@ public:
     DLLLOCAL int addFrames(const QoreListNode* l, ExceptionSink* xsink);
 
     DLLLOCAL zmsg_t** getPtr() {
+        index_valid = false;
         return &msg;
     }
 
+    // returns the number of frames in the message
+    DLLLOCAL size_t frameCount() {
+        checkIndex();
+        return index.size();
+    }
+
+    // returns the frame at the given position without removing it from the message; negative positions are
+    // offsets from the end of the message; returns nullptr if there is no frame at the given position
+    DLLLOCAL zframe_t* getFrame(int64 i) {
+        checkIndex();
+        if (i < 0)
+            i += index.size();
+        return (i < 0 || i >= (int64)index.size()) ? nullptr : index[i];
+    }
+
+    // returns a new message with copies of the frames from start up to but not including end; negative positions
+    // are offsets from the end of the message; returns nullptr if memory cannot be allocated
+    DLLLOCAL zmsg_t* slice(int64 start, int64 end);
+
     //! the error string for exceptions
     DLLLOCAL virtual const char* getErrorString() const {
         return "ZMSG-THREAD-ERROR";
@@ -71,6 +95,17 @@ protected:
 
 private:
     zmsg_t* msg = nullptr;
+
+    // frame index for non-destructive access by position; rebuilt on demand after the message is modified
+    std::vector<zframe_t*> index;
+    bool index_valid = false;
+
+    DLLLOCAL void checkIndex() {
+        if (!index_valid)
+            buildIndex();
+    }
+
+    DLLLOCAL void buildIndex();
 };
 
 DLLLOCAL extern QoreClass* QC_ZMSG;
@@ -0,0 +1,143 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QC_ZPoller.h defines the c++ implementation of the ZPoller class */
+/*
+    QC_ZPoller.h
+
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_ZMQ_QC_ZPOLLER_H
+
+#define _QORE_ZMQ_QC_ZPOLLER_H
+
+#include "zmq-module.h"
+
+#include "QC_ZSocket.h"
+
+#include <vector>
+
+// persistent set of poll items; holds references to the socket objects and their private data while registered
+class ZmqPollSet {
+public:
+    DLLLOCAL ~ZmqPollSet() {
+        assert(objs.empty());
+    }
+
+    // adds a socket and takes ownership of the references to obj and zsock; returns the index of the new item
+    DLLLOCAL size_t addSocket(QoreObject* obj, QoreZSock* zsock, short events) {
+        zsock->attach();
+        items.push_back({**zsock, 0, events, 0});
+        objs.push_back(obj);
+        socks.push_back(zsock);
+        return items.size() - 1;
+    }
+
+    // adds a file descriptor; returns the index of the new item
+    DLLLOCAL size_t addFd(int fd, short events) {
+        items.push_back({nullptr, fd, events, 0});
+        objs.push_back(nullptr);
+        socks.push_back(nullptr);
+        return items.size() - 1;
+    }
+
+    // returns the index of the given socket or -1 if not registered
+    DLLLOCAL int find(const QoreZSock* zsock) const {
+        for (size_t i = 0, e = socks.size(); i < e; ++i) {
+            if (socks[i] == zsock)
+                return (int)i;
+        }
+        return -1;
+    }
+
+    // returns the index of the given file descriptor or -1 if not registered
+    DLLLOCAL int findFd(int fd) const {
+        for (size_t i = 0, e = items.size(); i < e; ++i) {
+            if (!items[i].socket && items[i].fd == fd)
+                return (int)i;
+        }
+        return -1;
+    }
+
+    // removes the given item; the indexes of all following items are decremented
+    DLLLOCAL void remove(size_t i, ExceptionSink* xsink);
+
+    // removes all items
+    DLLLOCAL void clear(ExceptionSink* xsink);
+
+    // polls all items; returns the number of items with events, 0 on timeout, -1 for error (errno set)
+    DLLLOCAL int poll(int64 timeout_ms);
+
+    DLLLOCAL size_t size() const {
+        return items.size();
+    }
+
+    DLLLOCAL zmq_pollitem_t& operator[](size_t i) {
+        return items[i];
+    }
+
+    DLLLOCAL const zmq_pollitem_t& operator[](size_t i) const {
+        return items[i];
+    }
+
+    // returns the socket object for the given item or nullptr for file descriptor items
+    DLLLOCAL QoreObject* getObject(size_t i) const {
+        return objs[i];
+    }
+
+    // returns the socket for the given item or nullptr for file descriptor items
+    DLLLOCAL QoreZSock* getSocket(size_t i) const {
+        return socks[i];
+    }
+
+private:
+    std::vector<zmq_pollitem_t> items;
+    std::vector<QoreObject*> objs;
+    std::vector<QoreZSock*> socks;
+};
+
+class QoreZPoller : public AbstractZmqThreadLocalData {
+public:
+    DLLLOCAL ZmqPollSet& operator*() {
+        return pset;
+    }
+
+    DLLLOCAL const ZmqPollSet& operator*() const {
+        return pset;
+    }
+
+    DLLLOCAL virtual void deref(ExceptionSink* xsink) {
+        if (ROdereference()) {
+            pset.clear(xsink);
+            delete this;
+        }
+    }
+
+    //! the error string for exceptions
+    DLLLOCAL virtual const char* getErrorString() const {
+        return "ZPOLLER-THREAD-ERROR";
+    }
+
+private:
+    ZmqPollSet pset;
+};
+
+DLLLOCAL extern QoreClass* QC_ZPOLLER;
+DLLLOCAL extern qore_classid_t CID_ZPOLLER;
+
+#endif // _QORE_ZMQ_QC_ZPOLLER_H
@@ -0,0 +1,124 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QC_ZProxy.h defines the c++ implementation of the ZProxy class */
+/*
+    QC_ZProxy.h
+
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_ZMQ_QC_ZPROXY_H
+
+#define _QORE_ZMQ_QC_ZPROXY_H
+
+#include "zmq-module.h"
+
+#include "QC_ZSocket.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// runs a steerable proxy in a native thread owned by the module
+class QoreZProxy : public AbstractPrivateData {
+public:
+    // takes ownership of the references to the sockets and marks them as owned by the native thread
+    DLLLOCAL QoreZProxy(QoreZContext& ctx, QoreZSock* frontend, QoreZSock* backend, QoreZSock* capture,
+        ExceptionSink* xsink);
+
+    // starts the proxy thread; cpu < 0 means no CPU affinity
+    DLLLOCAL int start(int cpu, ExceptionSink* xsink);
+
+    // sends a PAUSE, RESUME or TERMINATE command to the running proxy
+    DLLLOCAL int command(const char* cmd, const char* meth, ExceptionSink* xsink);
+
+    // requests statistics from the running proxy
+    DLLLOCAL QoreHashNode* getStatistics(ExceptionSink* xsink);
+
+    // terminates the proxy and waits for the thread to exit
+    DLLLOCAL int stop(ExceptionSink* xsink);
+
+    // waits for the thread to exit
+    DLLLOCAL void join();
+
+    // returns the errno value that terminated the proxy or 0 if it was terminated with a TERMINATE command
+    DLLLOCAL int getErrno() const {
+        return proxy_errno;
+    }
+
+    DLLLOCAL bool isRunning() const {
+        return running;
+    }
+
+    DLLLOCAL bool isStarted() const {
+        return started;
+    }
+
+    DLLLOCAL int getCpu() const {
+        return cpu;
+    }
+
+    DLLLOCAL virtual void deref(ExceptionSink* xsink);
+
+protected:
+    DLLLOCAL virtual ~QoreZProxy();
+
+private:
+    QoreZSock* frontend;
+    QoreZSock* backend;
+    QoreZSock* capture;
+    // the proxy's control socket, used by the native thread
+    void* control = nullptr;
+    // the socket used to send commands to the proxy
+    void* commander = nullptr;
+
+    std::thread thread;
+    // serializes access to the commander socket and the thread state
+    std::mutex m;
+    // signaled when the proxy thread has applied its CPU affinity and when it exits
+    std::condition_variable cond;
+    std::atomic<bool> running{false};
+    // set by the proxy thread once it has applied its CPU affinity and is about to run the proxy
+    bool ready = false;
+    // an error code if the proxy thread could not apply its CPU affinity
+    int affinity_errno = 0;
+    bool started = false;
+    int cpu = -1;
+    // the proxy's result: 0 = terminated by command, otherwise the errno value
+    int proxy_errno = 0;
+
+    // the native thread function; the thread is pinned to the given CPU before the proxy is run if cpu >= 0
+    DLLLOCAL void run(int cpu);
+
+    // waits for the thread to exit and releases the sockets back to Qore; must be called with the lock held
+    DLLLOCAL void joinIntern(std::unique_lock<std::mutex>& lck);
+
+    // sets or clears native ownership of the proxied sockets
+    DLLLOCAL void setSocketsNativeOwned(bool owned) {
+        frontend->setNativeOwned(owned);
+        backend->setNativeOwned(owned);
+        if (capture)
+            capture->setNativeOwned(owned);
+    }
+};
+
+DLLLOCAL extern QoreClass* QC_ZPROXY;
+DLLLOCAL extern qore_classid_t CID_ZPROXY;
+
+#endif // _QORE_ZMQ_QC_ZPROXY_H
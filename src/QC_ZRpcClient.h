@@ -0,0 +1,135 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QC_ZRpcClient.h defines the c++ implementation of the ZRpcClient class */
+/*
+    QC_ZRpcClient.h
+
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_ZMQ_QC_ZRPCCLIENT_H
+
+#define _QORE_ZMQ_QC_ZRPCCLIENT_H
+
+#include "zmq-module.h"
+
+#include "QC_ZSocketDealer.h"
+
+#include <map>
+#include <unordered_map>
+
+// default option values
+#define ZRPC_DEFAULT_TIMEOUT 5000
+#define ZRPC_DEFAULT_RETRIES 0
+#define ZRPC_DEFAULT_MAX_PENDING 100000
+
+// the size of the request ID frame: a big-endian 64-bit integer
+#define ZRPC_ID_SIZE 8
+
+// a pipelined RPC client on a DEALER socket; requests are sent with an ID frame and an empty delimiter frame and
+// replies are matched to requests by ID, so any number of requests can be in flight at the same time; not
+// thread-safe, the object is only used by the thread that owns the socket
+class QoreZRpcClient : public AbstractPrivateData {
+public:
+    // takes ownership of the reference to the socket
+    DLLLOCAL QoreZRpcClient(QoreDealerZSock* sock, const QoreHashNode* opts, ExceptionSink* xsink);
+
+    // enforces access from the thread that owns the socket
+    DLLLOCAL int check(ExceptionSink* xsink) const {
+        return sock->check(xsink);
+    }
+
+    // sends a request; takes ownership of the message; timeout_ms < 0 means to use the default timeout; returns the
+    // request ID or -1 for error (exception raised)
+    DLLLOCAL int64 send(zmsg_t* body, int64 timeout_ms, ExceptionSink* xsink);
+
+    // returns up to max completed calls as a list of ZmqRpcResult hashes, waiting up to first_wait ms for the first
+    // completion; returns nullptr for error (exception raised)
+    DLLLOCAL QoreListNode* collect(int64 max, int first_wait, ExceptionSink* xsink);
+
+    // removes the given request from the table; later replies are discarded; returns true if the request was pending
+    DLLLOCAL bool cancel(int64 id);
+
+    DLLLOCAL int64 getPending() const {
+        return (int64)calls.size();
+    }
+
+    // returns a ZmqRpcInfo hash
+    DLLLOCAL QoreHashNode* getInfo(ExceptionSink* xsink) const;
+
+    DLLLOCAL virtual void deref(ExceptionSink* xsink);
+
+protected:
+    DLLLOCAL virtual ~QoreZRpcClient();
+
+private:
+    typedef std::multimap<int64, uint64_t> deadline_map_t;
+
+    struct Call {
+        // the request frames after the ID and delimiter frames; only kept if requests are retried
+        zmsg_t* body;
+        // the time the request was first sent in us
+        int64 start;
+        // the timeout for each attempt in ms
+        int64 timeout_ms;
+        // the number of times the request has been sent
+        int attempts;
+        // the position of the call in the deadline index
+        deadline_map_t::iterator deadline;
+    };
+
+    QoreDealerZSock* sock;
+
+    // the default timeout in ms
+    int64 timeout_ms;
+    // the number of times a request is sent again after a timeout
+    int64 retries;
+    // the maximum number of requests in flight
+    int64 max_pending;
+
+    // the ID for the next request
+    uint64_t next_id = 1;
+    // requests in flight by ID
+    std::unordered_map<uint64_t, Call> calls;
+    // requests in flight by deadline in us
+    deadline_map_t deadlines;
+
+    int64 sent = 0;
+    int64 retried = 0;
+    int64 completed = 0;
+    int64 timed_out = 0;
+    int64 discarded = 0;
+
+    // sends the ID and delimiter frames followed by the body; returns -1 for error (exception raised)
+    DLLLOCAL int sendRequest(uint64_t id, zmsg_t* body, const char* meth, ExceptionSink* xsink);
+
+    // retries or completes calls whose deadline has passed; returns -1 for error (exception raised)
+    DLLLOCAL int expire(int64 now, QoreListNode* rv, size_t max, ExceptionSink* xsink);
+
+    // reads replies queued on the socket without blocking; returns -1 for error (exception raised)
+    DLLLOCAL int readReplies(QoreListNode* rv, size_t max, ExceptionSink* xsink);
+
+    // removes the call from the table and returns a ZmqRpcResult hash
+    DLLLOCAL QoreHashNode* complete(std::unordered_map<uint64_t, Call>::iterator i, zmsg_t* reply, int64 now,
+        ExceptionSink* xsink);
+};
+
+DLLLOCAL extern QoreClass* QC_ZRPCCLIENT;
+DLLLOCAL extern qore_classid_t CID_ZRPCCLIENT;
+
+#endif // _QORE_ZMQ_QC_ZRPCCLIENT_H
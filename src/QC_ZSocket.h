@@ -29,9 +29,16 @@
 #include "zmq-module.h"
 
 #include "QC_ZContext.h"
+#include "QoreZSpool.h"
+#include "QoreZCompress.h"
+#include "QoreZLvc.h"
 
 #include <czmq.h>
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
 #include <string>
 
 #ifndef DEBUG
@@ -41,6 +48,42 @@
 // default timeout value: 2 minutes
 #define ZSOCK_TIMEOUT_MS 120000
 
+// serializes access to a socket shared by multiple threads; the counters are only updated and read while the lock is
+// held, so that a shared socket that has become a bottleneck can be detected without additional synchronization
+class QoreZSharedLock {
+public:
+    DLLLOCAL void lock() {
+        if (!m.try_lock()) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            m.lock();
+            int64 wait = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()
+                - start).count();
+            ++contended;
+            wait_us += wait;
+            if (wait > max_wait_us)
+                max_wait_us = wait;
+        }
+        ++acquisitions;
+    }
+
+    DLLLOCAL void unlock() {
+        m.unlock();
+    }
+
+    // returns a ZmqSharedInfo hash; must be called with the lock held
+    DLLLOCAL QoreHashNode* getInfo(ExceptionSink* xsink) const;
+
+private:
+    std::mutex m;
+    // the number of times the lock was acquired
+    int64 acquisitions = 0;
+    // the number of times the lock was held by another thread when it was requested
+    int64 contended = 0;
+    // the total and maximum time spent waiting for the lock in microseconds
+    int64 wait_us = 0;
+    int64 max_wait_us = 0;
+};
+
 class QoreZSock : public AbstractZmqThreadLocalData {
 public:
     // creates the object
@@ -95,8 +138,11 @@ public:
     DLLLOCAL int setSocketOption(int option_name, const void* option_value, size_t option_len) {
         while (true) {
             int rc = zmq_setsockopt(sock, option_name, option_value, option_len);
-            if (!rc)
+            if (!rc) {
+                if (option_name == ZMQ_MAXMSGSIZE && option_len == sizeof max_msg_size)
+                    memcpy(&max_msg_size, option_value, sizeof max_msg_size);
                 break;
+            }
             if (errno == EINTR)
                 continue;
             return -1;
@@ -117,6 +163,151 @@ public:
         return 0;
     }
 
+    // sends a single string or binary frame; frames at least as large as the zero-copy threshold are sent without
+    // copying the data; returns -1 for error (errno set), >= 0 for OK
+    DLLLOCAL int sendData(const QoreValue& v, const char* ptr, size_t len, int flags);
+
+    // sends a single frame, compressing it if compression is set; returns -1 for error (errno set), >= 0 for OK
+    DLLLOCAL int sendFrame(const char* ptr, size_t len, int flags);
+
+    // decodes a received frame if compression is set; returns 0 if the frame is not encoded, 1 if the frame has been
+    // decoded into a new null-terminated buffer allocated with malloc() and -1 for error (exception raised)
+    DLLLOCAL int decodeFrame(const void* data, size_t len, void*& out, size_t& out_len, ExceptionSink* xsink);
+
+    // decodes all frames of a received message in place if compression is set; returns -1 for error (exception
+    // raised), 0 for OK
+    DLLLOCAL int decodeMsg(zmsg_t* msg, ExceptionSink* xsink);
+
+    // waits up to timeout_ms for a message to be available for reading; a negative timeout means to wait
+    // indefinitely; returns 1 if a message is available, 0 on timeout, -1 for error (errno set)
+    DLLLOCAL int waitInput(int timeout_ms);
+
+    // returns true if a message can be read from the socket without blocking
+    DLLLOCAL bool hasInput() {
+        int events;
+        size_t len = sizeof events;
+        return !zmq_getsockopt(sock, ZMQ_EVENTS, &events, &len) && (events & ZMQ_POLLIN);
+    }
+
+    // receives a multipart message as a list of binary objects or, if an encoding is given, strings using a single
+    // reused zmq_msg_t; returns nullptr for error (errno set, no Qore exception raised unless a compressed frame
+    // cannot be decoded or cached messages cannot be replayed for a subscription)
+    DLLLOCAL QoreListNode* recvFrameList(int flags, ExceptionSink* xsink, const QoreEncoding* enc = nullptr);
+
+    //! returns the minimum frame size for zero-copy sends; -1 = zero-copy sends are disabled
+    DLLLOCAL int64 getZeroCopyThreshold() const {
+        return zero_copy_threshold;
+    }
+
+    //! sets the minimum frame size for zero-copy sends; a negative value disables zero-copy sends
+    DLLLOCAL void setZeroCopyThreshold(int64 min_size) {
+        zero_copy_threshold = min_size < 0 ? -1 : min_size;
+    }
+
+    //! returns the overflow spool or nullptr if none is set
+    DLLLOCAL QoreZSpool* getSpool() const {
+        return spool.get();
+    }
+
+    //! sets or removes the overflow spool
+    DLLLOCAL void setSpool(QoreZSpool* s) {
+        spool.reset(s);
+    }
+
+    //! returns the frame compression codec or nullptr if none is set
+    DLLLOCAL QoreZCompress* getCompression() const {
+        return compress.get();
+    }
+
+    //! sets or removes the frame compression codec
+    DLLLOCAL void setCompression(QoreZCompress* c) {
+        compress.reset(c);
+    }
+
+    //! returns the last-value cache or nullptr if none is set
+    DLLLOCAL QoreZLvc* getLvc() const {
+        return lvc.get();
+    }
+
+    //! sets or removes the last-value cache
+    DLLLOCAL void setLvc(QoreZLvc* c) {
+        lvc.reset(c);
+    }
+
+    // if a last-value cache is set and the received single-frame message is a subscription, replays the cached
+    // messages matching the subscription; returns -1 for error (exception raised), 0 for OK
+    DLLLOCAL int checkSubscription(const void* data, size_t len, ExceptionSink* xsink) {
+        if (!lvc || !len || *static_cast<const unsigned char*>(data) != 1)
+            return 0;
+        return replayLastValues(static_cast<const char*>(data) + 1, len - 1, xsink);
+    }
+
+    // checks a received message for a subscription; see checkSubscription(const void*, size_t, ExceptionSink*)
+    DLLLOCAL int checkSubscription(zmsg_t* msg, ExceptionSink* xsink) {
+        if (!lvc || zmsg_size(msg) != 1)
+            return 0;
+        zframe_t* f = zmsg_first(msg);
+        return checkSubscription(zframe_data(f), zframe_size(f), xsink);
+    }
+
+    // sends all cached messages with topics matching the given subscription prefix; returns -1 for error (exception
+    // raised), otherwise the number of messages sent
+    DLLLOCAL int64 replayLastValues(const char* prefix, size_t len, ExceptionSink* xsink);
+
+#ifdef QORE_BUILD_ZMQ_DRAFT
+    // sends a single-part message on a thread-safe draft socket with an optional routing ID (for SERVER sockets) or
+    // group (for RADIO sockets); returns -1 for error (errno set), >= 0 for OK
+    DLLLOCAL int sendSingle(const void* ptr, size_t len, uint32_t routing_id, const char* group);
+
+    // receives a single-part message from a thread-safe draft socket as a new message with the routing ID set; if
+    // group is not nullptr, the message's group is returned there; returns nullptr for error (errno set)
+    DLLLOCAL zmsg_t* recvSingle(int flags, std::string* group = nullptr);
+#endif
+
+    // sends a message without blocking if no messages are spooled, otherwise or if the socket would block, the
+    // message is appended to the spool; the spool must be set; returns -1 for error (exception raised), 0 for OK
+    DLLLOCAL int sendSpooled(const zmq_frame_vec_t& frames, const char* meth, ExceptionSink* xsink);
+
+    // puts the socket in shared mode, where it can be used from any thread and all access is serialized with an
+    // internal lock; returns -1 for error (exception raised), 0 for OK
+    DLLLOCAL int setShared(ExceptionSink* xsink);
+
+    //! returns the lock for shared mode or nullptr if the socket is not in shared mode
+    DLLLOCAL QoreZSharedLock* getSharedLock() const {
+        return shared.get();
+    }
+
+    // releases the socket from the current thread so that it can be adopted by another thread; fails if the socket
+    // is used by objects registered with attach(), as they would continue to use it in the current thread; returns
+    // -1 for error (exception raised), 0 for OK
+    DLLLOCAL int release(ExceptionSink* xsink);
+
+    // registers an object that uses the socket outside of the socket's lock (ZRpcClient, ZPoller, ZLoop); the socket
+    // cannot be put in shared mode or released while such objects are registered; the socket must have been checked with
+    // checkExclusive()
+    DLLLOCAL void attach() {
+        ++attached;
+    }
+
+    // unregisters an object registered with attach(); may be called from any thread when the object is deleted
+    DLLLOCAL void detach() {
+        assert(attached > 0);
+        --attached;
+    }
+
+    // like check(), but also fails for sockets in shared mode; for functions that use the socket outside of the
+    // socket's lock; returns -1 for error (exception raised), 0 for OK
+    DLLLOCAL int checkExclusive(const char* meth, ExceptionSink* xsink) const {
+        if (check(xsink))
+            return -1;
+        if (shared) {
+            xsink->raiseException("ZSOCKET-SHARED-ERROR", "%s socket is in shared mode and cannot be used with %s()",
+                getTypeName(), meth);
+            return -1;
+        }
+        return 0;
+    }
+
     //! the error string for exceptions
     DLLLOCAL virtual const char* getErrorString() const {
         return "ZSOCKET-THREAD-ERROR";
@@ -146,6 +337,98 @@ protected:
     }
 
     void* sock = nullptr;
+    // minimum frame size for zero-copy sends; -1 = disabled
+    int64 zero_copy_threshold = -1;
+    // the overflow spool for messages that cannot be sent without blocking
+    std::unique_ptr<QoreZSpool> spool;
+    // the frame compression codec
+    std::unique_ptr<QoreZCompress> compress;
+    // the ZMQ_MAXMSGSIZE value of the socket, which also limits the size of decompressed frames; -1 = no limit
+    int64 max_msg_size = -1;
+    // the last-value cache for XPUB sockets
+    std::unique_ptr<QoreZLvc> lvc;
+    // the lock serializing access in shared mode
+    std::unique_ptr<QoreZSharedLock> shared;
+    // the number of objects using the socket outside of the socket's lock; see attach()
+    std::atomic<int> attached{0};
+};
+
+// enforces access from the owning thread or, for sockets in shared mode, holds the socket's lock for the lifetime of
+// the object so that each operation, including multipart sends, is atomic with respect to other threads
+class QoreZSockAccessHelper {
+public:
+    DLLLOCAL QoreZSockAccessHelper(QoreZSock* zsock, ExceptionSink* xsink) {
+        if (zsock->check(xsink))
+            return;
+        lck = zsock->getSharedLock();
+        if (lck)
+            lck->lock();
+        valid = true;
+    }
+
+    DLLLOCAL ~QoreZSockAccessHelper() {
+        if (lck)
+            lck->unlock();
+    }
+
+    DLLLOCAL explicit operator bool() const {
+        return valid;
+    }
+
+private:
+    QoreZSharedLock* lck = nullptr;
+    bool valid = false;
+};
+
+// collects a message to be stored in the socket's last-value cache, if any, and stores it when the helper goes out of
+// scope, unless an exception has been raised in the meantime, so that a message that was not sent is never cached;
+// must be declared after a QoreZSockAccessHelper so that the cache is updated while the socket's lock is held
+class QoreZLvcUpdateHelper {
+public:
+    DLLLOCAL QoreZLvcUpdateHelper(QoreZSock* zsock, ExceptionSink* xsink) : lvc(zsock->getLvc()), xsink(xsink) {
+    }
+
+    DLLLOCAL ~QoreZLvcUpdateHelper() {
+        if (!lvc || *xsink)
+            return;
+        // copied frames are stored contiguously
+        size_t offset = 0;
+        for (size_t len : sizes) {
+            frames.push_back(std::make_pair(buf.data() + offset, len));
+            offset += len;
+        }
+        if (!frames.empty())
+            lvc->update(frames);
+    }
+
+    // adds a frame whose data remains valid until the helper goes out of scope
+    DLLLOCAL void add(const char* ptr, size_t len) {
+        frames.push_back(std::make_pair(ptr, len));
+    }
+
+    // adds a copy of a frame whose data is released when the message is sent
+    DLLLOCAL void addCopy(const char* ptr, size_t len) {
+        buf.append(ptr, len);
+        sizes.push_back(len);
+    }
+
+    // discards the message; used when a message is not sent without an exception being raised
+    DLLLOCAL void clear() {
+        frames.clear();
+        buf.clear();
+        sizes.clear();
+    }
+
+    DLLLOCAL explicit operator bool() const {
+        return lvc;
+    }
+
+private:
+    QoreZLvc* lvc;
+    ExceptionSink* xsink;
+    zmq_frame_vec_t frames;
+    std::string buf;
+    std::vector<size_t> sizes;
 };
 
 class QoreZSockBind : public QoreZSock {
@@ -182,6 +465,24 @@ public:
     }
 };
 
+// returns true if the given string is a valid PAUSE, RESUME or TERMINATE command for a steerable proxy; libzmq aborts
+// the process when a proxy receives an unknown command
+DLLLOCAL bool zmq_valid_proxy_command(const char* cmd, size_t len);
+
+// sends a command on a socket connected to the control socket of a steerable proxy; returns 0 for OK, -1 for error
+// (exception raised)
+DLLLOCAL int zmq_proxy_send_command(void* sock, const char* cmd, const char* meth, ExceptionSink* xsink);
+
+// requests statistics from a steerable proxy and returns a ZmqProxyStatistics hash; returns nullptr for error
+// (exception raised)
+DLLLOCAL QoreHashNode* zmq_proxy_get_statistics(void* sock, const char* meth, ExceptionSink* xsink);
+
+// marks the given sockets as owned by a native thread; null entries and sockets given more than once are ignored;
+// if any socket is already owned by a native thread, no socket is claimed; returns 0 for OK, -1 for error (exception
+// raised)
+DLLLOCAL int zmq_claim_native_sockets(QoreZSock* const* socks, size_t n, const char* meth, ExceptionSink* xsink);
+
 DLLLOCAL extern QoreClass* QC_ZSOCKET;
+DLLLOCAL extern qore_classid_t CID_ZSOCKET;
 
 #endif // _QORE_ZMQ_QC_ZSOCKET_H
@@ -9,7 +9,7 @@
 
   This library is free software; you can redistribute it and/or
   modify it under the terms of the GNU Lesser General Public
-  License as dishlished by the Free Software Foundation; either
+  License as published by the Free Software Foundation; either
   version 2.1 of the License, or (at your option) any later version.
 
   This library is distributed in the hope that it will be useful,
@@ -30,8 +30,9 @@
 
 class QoreDishZSock : public QoreZSockBind {
 public:
-   // creates the object
+   // creates the object; DISH sockets are thread-safe in ZeroMQ and can be used from any thread
    DLLLOCAL QoreDishZSock(QoreZContext& ctx, const char* endpoint, ExceptionSink* xsink) : QoreZSockBind(ctx, ZMQ_DISH, endpoint, xsink) {
+      setThreadSafe();
    }
 
    DLLLOCAL virtual int getType() const {
@@ -43,4 +43,7 @@ public:
    }
 };
 
+DLLLOCAL extern QoreClass* QC_ZSOCKETPUSH;
+DLLLOCAL extern qore_classid_t CID_ZSOCKETPUSH;
+
 #endif // _QORE_ZMQ_QC_ZSOCKETPUSH_H
@@ -9,7 +9,7 @@
 
   This library is free software; you can redistribute it and/or
   modify it under the terms of the GNU Lesser General Public
-  License as radiolished by the Free Software Foundation; either
+  License as published by the Free Software Foundation; either
   version 2.1 of the License, or (at your option) any later version.
 
   This library is distributed in the hope that it will be useful,
@@ -28,10 +28,11 @@
 
 #include "QC_ZSocket.h"
 
-class QoreRadioZSock : public QoreZSockBind {
+class QoreRadioZSock : public QoreZSockConnect {
 public:
-   // creates the object
+   // creates the object; RADIO sockets are thread-safe in ZeroMQ and can be used from any thread
    DLLLOCAL QoreRadioZSock(QoreZContext& ctx, const char* endpoint, ExceptionSink* xsink) : QoreZSockConnect(ctx, ZMQ_RADIO, endpoint, xsink) {
+      setThreadSafe();
    }
 
    DLLLOCAL virtual int getType() const {
@@ -0,0 +1,47 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QC_ZSocketServer.h defines the c++ implementation of the ZSocketServer class */
+/*
+    QC_ZSocketServer.h
+
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_ZMQ_QC_ZSOCKETSERVER_H
+
+#define _QORE_ZMQ_QC_ZSOCKETSERVER_H
+
+#include "QC_ZSocket.h"
+
+class QoreServerZSock : public QoreZSockBind {
+public:
+    // creates the object; SERVER sockets are thread-safe in ZeroMQ and can be used from any thread
+    DLLLOCAL QoreServerZSock(QoreZContext& ctx, const char* endpoint, ExceptionSink* xsink) : QoreZSockBind(ctx, ZMQ_SERVER, endpoint, xsink) {
+        setThreadSafe();
+    }
+
+    DLLLOCAL virtual int getType() const {
+        return ZMQ_SERVER;
+    }
+
+    DLLLOCAL virtual const char* getTypeName() const {
+        return "SERVER";
+    }
+};
+
+#endif // _QORE_ZMQ_QC_ZSOCKETSERVER_H
@@ -27,6 +27,9 @@
 #define _QORE_ZMQ_QC_ZSOCKETSTREAM_H
 
 #include "QC_ZSocket.h"
+#include "QoreZFramer.h"
+
+#include <memory>
 
 class QoreStreamZSock : public QoreZSockConnect {
 public:
@@ -41,6 +44,19 @@ public:
    DLLLOCAL virtual const char* getTypeName() const {
       return "STREAM";
    }
+
+   DLLLOCAL QoreZStreamFramer* getFramer() const {
+      return framer.get();
+   }
+
+   // takes ownership of the framer; data buffered by any previous framer is discarded
+   DLLLOCAL void setFramer(QoreZStreamFramer* f) {
+      framer.reset(f);
+   }
+
+private:
+   // per-connection message reassembly
+   std::unique_ptr<QoreZStreamFramer> framer;
 };
 
 #endif // _QORE_ZMQ_QC_ZSOCKETSTREAM_H
@@ -27,6 +27,9 @@
 #define _QORE_ZMQ_QC_ZSOCKETSUB_H
 
 #include "QC_ZSocket.h"
+#include "QoreZConflate.h"
+
+#include <memory>
 
 class QoreSubZSock : public QoreZSockConnect {
 public:
@@ -69,6 +72,19 @@ public:
 
       return subscribeIntern(xsink, *subs_utf8);
    }
+
+   DLLLOCAL QoreZConflate* getConflation() const {
+      return conflate.get();
+   }
+
+   // takes ownership of the buffer; pending messages in any previous buffer are discarded
+   DLLLOCAL void setConflation(QoreZConflate* c) {
+      conflate.reset(c);
+   }
+
+private:
+   // per-topic conflation buffer
+   std::unique_ptr<QoreZConflate> conflate;
 };
 
 #endif // _QORE_ZMQ_QC_ZSOCKETSUB_H
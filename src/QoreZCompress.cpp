@@ -0,0 +1,285 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QoreZCompress.cpp defines the per-frame compression codec for sockets */
+/*
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "QoreZCompress.h"
+
+#ifdef QORE_HAVE_LZ4
+#include <lz4.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(QORE_HAVE_ZSTD) && !defined(ZSTD_CLEVEL_DEFAULT)
+#define ZSTD_CLEVEL_DEFAULT 3
+#endif
+
+QoreZCompress* QoreZCompress::create(const char* name, int level, int64 min_size, ExceptionSink* xsink) {
+    int codec;
+    if (!strcmp(name, "none")) {
+        codec = ZCOMPRESS_STORED;
+    } else if (!strcmp(name, "lz4")) {
+#ifdef QORE_HAVE_LZ4
+        codec = ZCOMPRESS_LZ4;
+        if (level < 0) {
+            xsink->raiseException("ZSOCKET-COMPRESSION-ERROR", "invalid lz4 acceleration level %d; the level must "
+                "not be negative", level);
+            return nullptr;
+        }
+#else
+        xsink->raiseException("ZSOCKET-COMPRESSION-ERROR", "lz4 compression is not supported; the zmq module was "
+            "built without the lz4 library");
+        return nullptr;
+#endif
+    } else if (!strcmp(name, "zstd")) {
+#ifdef QORE_HAVE_ZSTD
+        codec = ZCOMPRESS_ZSTD;
+        if (level > ZSTD_maxCLevel()) {
+            xsink->raiseException("ZSOCKET-COMPRESSION-ERROR", "invalid zstd compression level %d; the maximum "
+                "level is %d", level, ZSTD_maxCLevel());
+            return nullptr;
+        }
+#else
+        xsink->raiseException("ZSOCKET-COMPRESSION-ERROR", "zstd compression is not supported; the zmq module was "
+            "built without the zstd library");
+        return nullptr;
+#endif
+    } else {
+        xsink->raiseException("ZSOCKET-COMPRESSION-ERROR", "unknown compression codec '%s'; expecting \"lz4\", "
+            "\"zstd\" or \"none\"", name);
+        return nullptr;
+    }
+
+    // frames no larger than the header cannot get smaller when compressed
+    if (min_size <= ZCOMPRESS_HEADER_SIZE) {
+        xsink->raiseException("ZSOCKET-COMPRESSION-ERROR", "invalid minimum frame size " QLLD "; the value must "
+            "be greater than the %d-byte frame header", min_size, ZCOMPRESS_HEADER_SIZE);
+        return nullptr;
+    }
+
+    QoreZCompress* rv = new QoreZCompress(codec, level, min_size);
+#ifdef QORE_HAVE_ZSTD
+    if (codec == ZCOMPRESS_ZSTD) {
+        rv->cctx = ZSTD_createCCtx();
+        if (!rv->cctx) {
+            delete rv;
+            xsink->outOfMemory();
+            return nullptr;
+        }
+    }
+#endif
+    return rv;
+}
+
+QoreZCompress::~QoreZCompress() {
+#ifdef QORE_HAVE_ZSTD
+    ZSTD_freeCCtx(cctx);
+    ZSTD_freeDCtx(dctx);
+    ZSTD_freeCDict(cdict);
+    ZSTD_freeDDict(ddict);
+#endif
+}
+
+const char* QoreZCompress::getCodecName() const {
+    switch (codec) {
+        case ZCOMPRESS_LZ4: return "lz4";
+        case ZCOMPRESS_ZSTD: return "zstd";
+    }
+    return "none";
+}
+
+int QoreZCompress::setDictionary(const void* data, size_t len, ExceptionSink* xsink) {
+#ifdef QORE_HAVE_ZSTD
+    ZSTD_freeCDict(cdict);
+    ZSTD_freeDDict(ddict);
+    cdict = nullptr;
+    ddict = nullptr;
+    // an empty dictionary removes the dictionary
+    if (!len)
+        return 0;
+
+    cdict = ZSTD_createCDict(data, len, level ? level : ZSTD_CLEVEL_DEFAULT);
+    ddict = ZSTD_createDDict(data, len);
+    if (!cdict || !ddict) {
+        ZSTD_freeCDict(cdict);
+        ZSTD_freeDDict(ddict);
+        cdict = nullptr;
+        ddict = nullptr;
+        xsink->raiseException("ZSOCKET-COMPRESSION-ERROR", "cannot create a zstd dictionary from %lld bytes of data",
+            (int64)len);
+        return -1;
+    }
+    return 0;
+#else
+    xsink->raiseException("ZSOCKET-COMPRESSION-ERROR", "compression dictionaries require zstd; the zmq module was "
+        "built without the zstd library");
+    return -1;
+#endif
+}
+
+char* QoreZCompress::encode(const char* ptr, size_t len, size_t& out_len) {
+    int c = (codec != ZCOMPRESS_STORED && len >= (size_t)min_size && len <= 0xffffffffull)
+        ? codec
+        : ZCOMPRESS_STORED;
+
+    size_t bound = len;
+#ifdef QORE_HAVE_LZ4
+    if (c == ZCOMPRESS_LZ4)
+        bound = LZ4_compressBound((int)len);
+#endif
+#ifdef QORE_HAVE_ZSTD
+    if (c == ZCOMPRESS_ZSTD)
+        bound = ZSTD_compressBound(len);
+#endif
+    if (bound < len)
+        bound = len;
+
+    char* buf = static_cast<char*>(malloc(ZCOMPRESS_HEADER_SIZE + bound));
+    if (!buf) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+    char* dst = buf + ZCOMPRESS_HEADER_SIZE;
+
+    size_t clen = 0;
+#ifdef QORE_HAVE_LZ4
+    if (c == ZCOMPRESS_LZ4) {
+        int rc = LZ4_compress_fast(ptr, dst, (int)len, (int)bound, level ? level : 1);
+        if (rc > 0)
+            clen = rc;
+    }
+#endif
+#ifdef QORE_HAVE_ZSTD
+    if (c == ZCOMPRESS_ZSTD) {
+        size_t rc;
+        if (cdict) {
+            rc = ZSTD_compress_usingCDict(cctx, dst, bound, ptr, len, cdict);
+            c = ZCOMPRESS_ZSTD_DICT;
+        } else {
+            rc = ZSTD_compressCCtx(cctx, dst, bound, ptr, len, level ? level : ZSTD_CLEVEL_DEFAULT);
+        }
+        if (!ZSTD_isError(rc))
+            clen = rc;
+    }
+#endif
+
+    // frames that cannot be compressed or do not get smaller are stored uncompressed
+    if (!clen || clen >= len) {
+        c = ZCOMPRESS_STORED;
+        memcpy(dst, ptr, len);
+        clen = len;
+    }
+
+    memcpy(buf, ZCOMPRESS_MAGIC, ZCOMPRESS_MAGIC_LEN);
+    buf[3] = (char)c;
+    uint32_t size = (uint32_t)len;
+    buf[4] = (char)(size >> 24);
+    buf[5] = (char)(size >> 16);
+    buf[6] = (char)(size >> 8);
+    buf[7] = (char)size;
+
+    out_len = ZCOMPRESS_HEADER_SIZE + clen;
+    return buf;
+}
+
+int QoreZCompress::decode(const void* data, size_t len, int64 max_size, void*& out, size_t& out_len,
+        ExceptionSink* xsink) {
+    if (!isEncoded(data, len))
+        return 0;
+
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    int c = p[3];
+    const char* src = reinterpret_cast<const char*>(p + ZCOMPRESS_HEADER_SIZE);
+    size_t src_len = len - ZCOMPRESS_HEADER_SIZE;
+    size_t size = c == ZCOMPRESS_STORED
+        ? src_len
+        : ((size_t)p[4] << 24) | ((size_t)p[5] << 16) | ((size_t)p[6] << 8) | (size_t)p[7];
+
+    if (max_size >= 0 && size > (size_t)max_size) {
+        xsink->raiseException("ZSOCKET-COMPRESSION-ERROR", "compressed frame would decompress to %lld bytes, "
+            "exceeding the socket's maximum message size of " QLLD " bytes", (int64)size, max_size);
+        return -1;
+    }
+
+    // a terminating null byte is added so that the buffer can also be used for strings
+    char* buf = static_cast<char*>(malloc(size + 1));
+    if (!buf) {
+        xsink->outOfMemory();
+        return -1;
+    }
+    buf[size] = '\0';
+
+    bool ok = false;
+    switch (c) {
+        case ZCOMPRESS_STORED:
+            memcpy(buf, src, size);
+            ok = true;
+            break;
+
+#ifdef QORE_HAVE_LZ4
+        case ZCOMPRESS_LZ4: {
+            int rc = LZ4_decompress_safe(src, buf, (int)src_len, (int)size);
+            ok = rc >= 0 && (size_t)rc == size;
+            break;
+        }
+#endif
+
+#ifdef QORE_HAVE_ZSTD
+        case ZCOMPRESS_ZSTD:
+        case ZCOMPRESS_ZSTD_DICT: {
+            if (c == ZCOMPRESS_ZSTD_DICT && !ddict) {
+                free(buf);
+                xsink->raiseException("ZSOCKET-COMPRESSION-ERROR", "received a frame compressed with a zstd "
+                    "dictionary, but no dictionary has been set with ZSocket::setCompressionDictionary()");
+                return -1;
+            }
+            if (!dctx) {
+                dctx = ZSTD_createDCtx();
+                if (!dctx)
+                    break;
+            }
+            size_t rc = c == ZCOMPRESS_ZSTD_DICT
+                ? ZSTD_decompress_usingDDict(dctx, buf, size, src, src_len, ddict)
+                : ZSTD_decompressDCtx(dctx, buf, size, src, src_len);
+            ok = !ZSTD_isError(rc) && rc == size;
+            break;
+        }
+#endif
+
+        default:
+            free(buf);
+            xsink->raiseException("ZSOCKET-COMPRESSION-ERROR", "received a frame with unsupported compression "
+                "codec %d", c);
+            return -1;
+    }
+
+    if (!ok) {
+        free(buf);
+        xsink->raiseException("ZSOCKET-COMPRESSION-ERROR", "received a corrupt compressed frame of %lld bytes",
+            (int64)len);
+        return -1;
+    }
+
+    out = buf;
+    out_len = size;
+    return 1;
+}
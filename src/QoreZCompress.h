@@ -0,0 +1,113 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QoreZCompress.h defines the per-frame compression codec for sockets */
+/*
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_ZMQ_QOREZCOMPRESS_H
+
+#define _QORE_ZMQ_QOREZCOMPRESS_H
+
+#include "zmq-module.h"
+
+#include <string.h>
+
+#ifdef QORE_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// the magic value at the start of every encoded frame
+#define ZCOMPRESS_MAGIC "\xffQZ"
+#define ZCOMPRESS_MAGIC_LEN 3
+// the size of the frame header: magic, codec and the big-endian 32-bit original size
+#define ZCOMPRESS_HEADER_SIZE 8
+
+// codecs; the values are stored in the frame header
+// the frame data is stored uncompressed; used for frames that would otherwise be mistaken for encoded frames
+#define ZCOMPRESS_STORED 0
+#define ZCOMPRESS_LZ4 1
+#define ZCOMPRESS_ZSTD 2
+// zstd with the shared dictionary
+#define ZCOMPRESS_ZSTD_DICT 3
+
+// the default minimum frame size for compression
+#define ZCOMPRESS_DEFAULT_MIN_SIZE 256
+
+// compresses outgoing frames and decompresses incoming frames for a single socket; not thread-safe, the object is
+// only used by the thread that owns the socket
+class QoreZCompress {
+public:
+    // creates the object; returns nullptr for error (exception raised)
+    DLLLOCAL static QoreZCompress* create(const char* codec, int level, int64 min_size, ExceptionSink* xsink);
+
+    DLLLOCAL ~QoreZCompress();
+
+    // sets the shared zstd dictionary for compression and decompression; returns -1 for error (exception raised)
+    DLLLOCAL int setDictionary(const void* data, size_t len, ExceptionSink* xsink);
+
+    // returns true if the frame has to be encoded before sending; empty frames are never encoded, as they are used
+    // as envelope delimiters
+    DLLLOCAL bool needsEncoding(const char* ptr, size_t len) const {
+        return len && ((codec != ZCOMPRESS_STORED && len >= (size_t)min_size && len <= 0xffffffffull)
+            || isEncoded(ptr, len));
+    }
+
+    // encodes a frame into a new buffer allocated with malloc(); returns nullptr if memory cannot be allocated
+    // (errno set)
+    DLLLOCAL char* encode(const char* ptr, size_t len, size_t& out_len);
+
+    // decodes a received frame; returns 0 if the frame is not encoded, 1 if the frame has been decoded into a new
+    // null-terminated buffer allocated with malloc() and -1 for error (exception raised); max_size is the maximum
+    // decoded size allowed or -1 for no limit
+    DLLLOCAL int decode(const void* data, size_t len, int64 max_size, void*& out, size_t& out_len,
+            ExceptionSink* xsink);
+
+    // returns the codec name
+    DLLLOCAL const char* getCodecName() const;
+
+    DLLLOCAL int getLevel() const {
+        return level;
+    }
+
+    DLLLOCAL int64 getMinSize() const {
+        return min_size;
+    }
+
+    // returns true if the frame starts with the frame header magic value
+    DLLLOCAL static bool isEncoded(const void* ptr, size_t len) {
+        return len >= ZCOMPRESS_HEADER_SIZE && !memcmp(ptr, ZCOMPRESS_MAGIC, ZCOMPRESS_MAGIC_LEN);
+    }
+
+private:
+    int codec;
+    int level;
+    int64 min_size;
+
+#ifdef QORE_HAVE_ZSTD
+    ZSTD_CCtx* cctx = nullptr;
+    ZSTD_DCtx* dctx = nullptr;
+    ZSTD_CDict* cdict = nullptr;
+    ZSTD_DDict* ddict = nullptr;
+#endif
+
+    DLLLOCAL QoreZCompress(int codec, int level, int64 min_size) : codec(codec), level(level), min_size(min_size) {
+    }
+};
+
+#endif // _QORE_ZMQ_QOREZCOMPRESS_H
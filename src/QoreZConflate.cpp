@@ -0,0 +1,109 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QoreZConflate.cpp defines the per-topic conflation buffer for SUB sockets */
+/*
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "QoreZConflate.h"
+#include "QC_ZSocket.h"
+
+QoreZConflate::QoreZConflate(const QoreHashNode* opts, ExceptionSink* xsink) :
+        max_topics(ZCONFLATE_DEFAULT_MAX_TOPICS) {
+    if (opts) {
+        QoreValue v = opts->getKeyValue("max_topics");
+        if (!v.isNothing())
+            max_topics = v.getAsBigInt();
+    }
+
+    if (max_topics < 1) {
+        xsink->raiseException("ZSOCKET-CONFLATE-ERROR", "invalid maximum number of topics " QLLD "; the value must "
+            "be positive", max_topics);
+        return;
+    }
+}
+
+QoreZConflate::~QoreZConflate() {
+    for (Item& i : queue)
+        zmsg_destroy(&i.msg);
+}
+
+int64 QoreZConflate::fill(QoreZSock& sock, ExceptionSink* xsink) {
+    int64 count = 0;
+    int64 limit = max_topics > ZCONFLATE_MIN_FILL ? max_topics : ZCONFLATE_MIN_FILL;
+    // messages for new topics are left in the socket's queue while the buffer is full
+    while (count < limit && (int64)queue.size() < max_topics && sock.hasInput()) {
+        zmsg_t* msg;
+        while (true) {
+            msg = zmsg_recv(*sock);
+            if (!msg && errno == EINTR)
+                continue;
+            break;
+        }
+        if (!msg) {
+            if (errno == EAGAIN)
+                break;
+            zmq_error(xsink, "ZSOCKET-RECVMSG-ERROR", "error receiving a message for conflation");
+            return -1;
+        }
+        if (sock.decodeMsg(msg, xsink)) {
+            zmsg_destroy(&msg);
+            return -1;
+        }
+        ++received;
+        ++count;
+
+        zframe_t* f = zmsg_first(msg);
+        std::string topic;
+        if (f)
+            topic.assign(reinterpret_cast<const char*>(zframe_data(f)), zframe_size(f));
+
+        auto i = index.find(topic);
+        if (i != index.end()) {
+            // the newer message replaces the pending message and keeps its position in the queue
+            zmsg_destroy(&i->second->msg);
+            i->second->msg = msg;
+            ++conflated;
+            continue;
+        }
+        queue.push_back({topic, msg});
+        index.emplace(std::move(topic), std::prev(queue.end()));
+    }
+    return count;
+}
+
+zmsg_t* QoreZConflate::pop() {
+    if (queue.empty())
+        return nullptr;
+    Item& i = queue.front();
+    zmsg_t* msg = i.msg;
+    index.erase(i.topic);
+    queue.pop_front();
+    ++delivered;
+    return msg;
+}
+
+QoreHashNode* QoreZConflate::getInfo(ExceptionSink* xsink) const {
+    ReferenceHolder<QoreHashNode> h(new QoreHashNode(hashdeclZmqConflationInfo, xsink), xsink);
+    h->setKeyValue("pending", (int64)queue.size(), xsink);
+    h->setKeyValue("max_topics", max_topics, xsink);
+    h->setKeyValue("received", received, xsink);
+    h->setKeyValue("delivered", delivered, xsink);
+    h->setKeyValue("conflated", conflated, xsink);
+    return h.release();
+}
@@ -0,0 +1,89 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QoreZConflate.h defines the per-topic conflation buffer for SUB sockets */
+/*
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_ZMQ_QOREZCONFLATE_H
+
+#define _QORE_ZMQ_QOREZCONFLATE_H
+
+#include "zmq-module.h"
+
+#include <czmq.h>
+
+#include <list>
+#include <string>
+#include <unordered_map>
+
+// the default maximum number of topics buffered
+#define ZCONFLATE_DEFAULT_MAX_TOPICS 100000
+
+// the minimum number of messages received in a single call to QoreZConflate::fill(); the limit is the greater of this
+// value and the maximum number of topics
+#define ZCONFLATE_MIN_FILL 10000
+
+class QoreZSock;
+
+// buffers received messages keyed by topic, which is the first frame of the message, keeping only the newest message
+// for each topic; topics are delivered in the order they were first received since they were last delivered; not
+// thread-safe, the buffer is only used by the thread that owns the socket
+class QoreZConflate {
+public:
+    DLLLOCAL QoreZConflate(const QoreHashNode* opts, ExceptionSink* xsink);
+
+    DLLLOCAL ~QoreZConflate();
+
+    // receives messages available on the socket without blocking until the buffer holds the maximum number of
+    // topics or the per-call message limit has been reached, so that a publisher sending faster than the messages
+    // can be read cannot keep the call from returning; returns -1 for error (exception raised), otherwise the number
+    // of messages received
+    DLLLOCAL int64 fill(QoreZSock& sock, ExceptionSink* xsink);
+
+    // removes and returns the message for the oldest pending topic; returns nullptr if no messages are pending
+    DLLLOCAL zmsg_t* pop();
+
+    DLLLOCAL bool empty() const {
+        return queue.empty();
+    }
+
+    // returns a ZmqConflationInfo hash
+    DLLLOCAL QoreHashNode* getInfo(ExceptionSink* xsink) const;
+
+private:
+    struct Item {
+        std::string topic;
+        zmsg_t* msg;
+    };
+    typedef std::list<Item> item_list_t;
+
+    // the maximum number of topics buffered
+    int64 max_topics;
+
+    // pending messages in delivery order
+    item_list_t queue;
+    // pending messages by topic
+    std::unordered_map<std::string, item_list_t::iterator> index;
+
+    int64 received = 0;
+    int64 delivered = 0;
+    int64 conflated = 0;
+};
+
+#endif // _QORE_ZMQ_QOREZCONFLATE_H
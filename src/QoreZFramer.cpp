@@ -0,0 +1,372 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QoreZFramer.cpp defines message framing for STREAM sockets */
+/*
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "QoreZFramer.h"
+#include "QC_ZSocket.h"
+
+#include <ctype.h>
+#include <string.h>
+
+// returns the offset of the first occurrence of the pattern in the data or -1 if not found
+static int64 zframer_find(const char* data, size_t len, const char* pat, size_t plen) {
+    if (len < plen)
+        return -1;
+    const char* end = data + len - plen + 1;
+    for (const char* p = data; p < end; ++p) {
+        p = static_cast<const char*>(memchr(p, pat[0], end - p));
+        if (!p)
+            return -1;
+        if (!memcmp(p, pat, plen))
+            return p - data;
+    }
+    return -1;
+}
+
+// messages preceded by an unsigned integer length header
+class QoreZLengthFramer : public QoreZFramer {
+public:
+    DLLLOCAL QoreZLengthFramer(int64 max_size, unsigned hsize, bool little_endian) : QoreZFramer(max_size),
+            hsize(hsize), little_endian(little_endian) {
+    }
+
+    DLLLOCAL virtual int next(const char* data, size_t len, size_t& scan, size_t& consumed, size_t& start,
+            size_t& size) const {
+        if (len < hsize)
+            return 0;
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+        uint64_t n = 0;
+        for (unsigned i = 0; i < hsize; ++i) {
+            n = (n << 8) | p[little_endian ? hsize - i - 1 : i];
+        }
+        if (n > (uint64_t)max_size)
+            return -1;
+        if (len - hsize < n)
+            return 0;
+        consumed = hsize + n;
+        start = hsize;
+        size = n;
+        return 1;
+    }
+
+    DLLLOCAL virtual const char* getType() const {
+        return "length";
+    }
+
+private:
+    unsigned hsize;
+    bool little_endian;
+};
+
+// messages terminated by a delimiter
+class QoreZDelimiterFramer : public QoreZFramer {
+public:
+    DLLLOCAL QoreZDelimiterFramer(int64 max_size, const char* delim, size_t len) : QoreZFramer(max_size),
+            delim(delim, len) {
+    }
+
+    DLLLOCAL virtual int next(const char* data, size_t len, size_t& scan, size_t& consumed, size_t& start,
+            size_t& size) const {
+        int64 pos = zframer_find(data + scan, len - scan, delim.data(), delim.size());
+        if (pos < 0) {
+            if (len > (size_t)max_size)
+                return -1;
+            // the delimiter may start in the data already searched
+            scan = len >= delim.size() ? len - delim.size() + 1 : 0;
+            return 0;
+        }
+        pos += scan;
+        if (pos > max_size)
+            return -1;
+        consumed = pos + delim.size();
+        start = 0;
+        size = pos;
+        return 1;
+    }
+
+    DLLLOCAL virtual const char* getType() const {
+        return "delimiter";
+    }
+
+private:
+    std::string delim;
+};
+
+// HTTP/1.x messages: the header followed by the number of bytes given by the Content-Length header
+class QoreZHttpFramer : public QoreZFramer {
+public:
+    DLLLOCAL QoreZHttpFramer(int64 max_size) : QoreZFramer(max_size) {
+    }
+
+    DLLLOCAL virtual int next(const char* data, size_t len, size_t& scan, size_t& consumed, size_t& start,
+            size_t& size) const {
+        int64 pos = zframer_find(data + scan, len - scan, "\r\n\r\n", 4);
+        if (pos < 0) {
+            if (len > (size_t)max_size)
+                return -1;
+            scan = len >= 4 ? len - 3 : 0;
+            return 0;
+        }
+        size_t hlen = scan + pos + 4;
+        int64 clen = getContentLength(data, hlen);
+        if (clen < 0 || hlen + clen > (uint64_t)max_size)
+            return -1;
+        if (len < hlen + clen) {
+            // the header has already been found; the end of the header is searched again when more data arrives
+            // from the last position, which finds it immediately
+            scan = hlen - 4;
+            return 0;
+        }
+        consumed = hlen + clen;
+        start = 0;
+        size = consumed;
+        return 1;
+    }
+
+    DLLLOCAL virtual const char* getType() const {
+        return "http";
+    }
+
+private:
+    // returns the value of the Content-Length header, 0 if there is none, or -1 if the value is invalid or the
+    // message uses chunked transfer encoding
+    DLLLOCAL static int64 getContentLength(const char* data, size_t hlen) {
+        static const char cl[] = "content-length:";
+        static const char te[] = "transfer-encoding:";
+        int64 rv = 0;
+        const char* end = data + hlen;
+        // skip the request or status line
+        const char* p = static_cast<const char*>(memchr(data, '\n', hlen));
+        while (p && ++p < end) {
+            const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+            size_t llen = (eol ? eol : end) - p;
+            if (llen > sizeof(cl) - 1 && !strncasecmp(p, cl, sizeof(cl) - 1)) {
+                const char* v = p + sizeof(cl) - 1;
+                while (v < eol && (*v == ' ' || *v == '\t'))
+                    ++v;
+                if (v == eol || !isdigit(*v))
+                    return -1;
+                rv = 0;
+                while (v < eol && isdigit(*v)) {
+                    rv = rv * 10 + (*v - '0');
+                    // values larger than any valid maximum size are rejected by the caller
+                    if (rv > (1ll << 48))
+                        return -1;
+                    ++v;
+                }
+            } else if (llen > sizeof(te) - 1 && !strncasecmp(p, te, sizeof(te) - 1)) {
+                // only messages with an explicit length are supported
+                return -1;
+            }
+            p = eol;
+        }
+        return rv;
+    }
+};
+
+QoreZFramer* QoreZFramer::create(const QoreHashNode* opts, int64& max_size, ExceptionSink* xsink) {
+    max_size = ZFRAMER_DEFAULT_MAX_SIZE;
+    QoreValue v = opts->getKeyValue("max_size");
+    if (!v.isNothing())
+        max_size = v.getAsBigInt();
+    if (max_size < 1) {
+        xsink->raiseException("ZSOCKET-FRAMER-ERROR", "invalid maximum message size " QLLD "; the value must be "
+            "positive", max_size);
+        return nullptr;
+    }
+
+    v = opts->getKeyValue("type");
+    if (v.getType() != NT_STRING) {
+        xsink->raiseException("ZSOCKET-FRAMER-ERROR", "missing framer type; expecting \"length\", \"delimiter\" or "
+            "\"http\"");
+        return nullptr;
+    }
+    const QoreStringNode* type = v.get<const QoreStringNode>();
+
+    if (*type == "length") {
+        int64 hsize = 4;
+        v = opts->getKeyValue("length_size");
+        if (!v.isNothing())
+            hsize = v.getAsBigInt();
+        if (hsize != 1 && hsize != 2 && hsize != 4 && hsize != 8) {
+            xsink->raiseException("ZSOCKET-FRAMER-ERROR", "invalid length header size " QLLD "; expecting 1, 2, 4 "
+                "or 8", hsize);
+            return nullptr;
+        }
+        return new QoreZLengthFramer(max_size, (unsigned)hsize, opts->getKeyValue("little_endian").getAsBool());
+    }
+
+    if (*type == "delimiter") {
+        const char* ptr = "\r\n";
+        size_t len = 2;
+        v = opts->getKeyValue("delimiter");
+        if (!v.isNothing() && q_get_data(v, ptr, len)) {
+            xsink->raiseException("ZSOCKET-FRAMER-ERROR", "invalid delimiter type '%s'; expecting 'string' or "
+                "'binary'", v.getTypeName());
+            return nullptr;
+        }
+        if (!len) {
+            xsink->raiseException("ZSOCKET-FRAMER-ERROR", "the delimiter cannot be empty");
+            return nullptr;
+        }
+        return new QoreZDelimiterFramer(max_size, ptr, len);
+    }
+
+    if (*type == "http")
+        return new QoreZHttpFramer(max_size);
+
+    xsink->raiseException("ZSOCKET-FRAMER-ERROR", "unknown framer type \"%s\"; expecting \"length\", \"delimiter\" "
+        "or \"http\"", type->c_str());
+    return nullptr;
+}
+
+QoreZStreamFramer::~QoreZStreamFramer() {
+    for (Item& i : ready) {
+        if (i.data)
+            i.data->deref();
+    }
+}
+
+int64 QoreZStreamFramer::extract(const std::string& id, Conn& c, const char* data, size_t len) {
+    size_t off = 0;
+    while (off < len) {
+        size_t consumed, start, size;
+        int rc = framer->next(data + off, len - off, c.scan, consumed, start, size);
+        if (rc < 0)
+            return -1;
+        if (!rc)
+            break;
+        BinaryNode* b = new BinaryNode;
+        b->append(data + off + start, size);
+        ready.push_back({id, "message", b});
+        ++messages;
+        off += consumed;
+        c.scan = 0;
+    }
+    return off;
+}
+
+int QoreZStreamFramer::process(const std::string& id, Conn& c, const char* data, size_t len) {
+    if (c.buf.empty()) {
+        // complete messages are taken directly from the received data; only the remainder is buffered
+        int64 off = extract(id, c, data, len);
+        if (off < 0)
+            return -1;
+        c.buf.assign(data + off, len - off);
+        return 0;
+    }
+
+    c.buf.append(data, len);
+    int64 off = extract(id, c, c.buf.data(), c.buf.size());
+    if (off < 0)
+        return -1;
+    c.buf.erase(0, off);
+    return 0;
+}
+
+int QoreZStreamFramer::fill(QoreZSock& sock, size_t max, ExceptionSink* xsink) {
+    zmq_msg_t idm, msg;
+    zmq_msg_init(&idm);
+    zmq_msg_init(&msg);
+    ON_BLOCK_EXIT(zmq_msg_close, &idm);
+    ON_BLOCK_EXIT(zmq_msg_close, &msg);
+
+    while (ready.size() < max && sock.hasInput()) {
+        int rc;
+        while ((rc = zmq_msg_recv(&idm, *sock, ZMQ_DONTWAIT)) < 0 && errno == EINTR) {
+        }
+        if (rc >= 0 && zmq_msg_more(&idm)) {
+            while ((rc = zmq_msg_recv(&msg, *sock, 0)) < 0 && errno == EINTR) {
+            }
+        }
+        if (rc < 0) {
+            if (errno == EAGAIN)
+                break;
+            zmq_error(xsink, "ZSOCKET-RECVMSG-ERROR", "error receiving data in ZSocketStream::recvFramed()");
+            return -1;
+        }
+        // ignore messages without a data frame
+        if (!zmq_msg_more(&idm))
+            continue;
+
+        std::string id(static_cast<const char*>(zmq_msg_data(&idm)), zmq_msg_size(&idm));
+        size_t len = zmq_msg_size(&msg);
+        auto i = conns.find(id);
+        // zero-length messages signal that a connection has been established or closed
+        if (!len) {
+            if (i == conns.end()) {
+                conns.emplace(id, Conn());
+                ready.push_back({std::move(id), "connect", nullptr});
+            } else {
+                conns.erase(i);
+                ready.push_back({std::move(id), "disconnect", nullptr});
+            }
+            continue;
+        }
+        if (i == conns.end())
+            i = conns.emplace(id, Conn()).first;
+        else if (i->second.closed)
+            continue;
+        if (process(id, i->second, static_cast<const char*>(zmq_msg_data(&msg)), len)) {
+            // invalid data or a message that is too large; the connection is closed and any further data received
+            // before the close takes effect is discarded
+            i->second.buf.clear();
+            i->second.closed = true;
+            ++errors;
+            ready.push_back({id, "error", nullptr});
+            zmq_send(*sock, id.data(), id.size(), ZMQ_SNDMORE);
+            zmq_send(*sock, nullptr, 0, 0);
+        }
+    }
+    return 0;
+}
+
+QoreHashNode* QoreZStreamFramer::pop(ExceptionSink* xsink) {
+    if (ready.empty())
+        return nullptr;
+    Item& i = ready.front();
+    ReferenceHolder<QoreHashNode> h(new QoreHashNode(hashdeclZmqStreamMessage, xsink), xsink);
+    BinaryNode* id = new BinaryNode;
+    id->append(i.id.data(), i.id.size());
+    h->setKeyValue("id", id, xsink);
+    h->setKeyValue("event", new QoreStringNode(i.event), xsink);
+    if (i.data)
+        h->setKeyValue("data", i.data, xsink);
+    ready.pop_front();
+    return h.release();
+}
+
+QoreHashNode* QoreZStreamFramer::getInfo(ExceptionSink* xsink) const {
+    int64 buffered = 0;
+    for (auto& i : conns) {
+        buffered += i.second.buf.size();
+    }
+
+    ReferenceHolder<QoreHashNode> h(new QoreHashNode(hashdeclZmqFramerInfo, xsink), xsink);
+    h->setKeyValue("type", new QoreStringNode(framer->getType()), xsink);
+    h->setKeyValue("max_size", max_size, xsink);
+    h->setKeyValue("connections", (int64)conns.size(), xsink);
+    h->setKeyValue("buffered", buffered, xsink);
+    h->setKeyValue("pending", (int64)ready.size(), xsink);
+    h->setKeyValue("messages", messages, xsink);
+    h->setKeyValue("errors", errors, xsink);
+    return h.release();
+}
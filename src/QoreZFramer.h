@@ -0,0 +1,130 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QoreZFramer.h defines message framing for STREAM sockets */
+/*
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_ZMQ_QOREZFRAMER_H
+
+#define _QORE_ZMQ_QOREZFRAMER_H
+
+#include "zmq-module.h"
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// the default maximum message size
+#define ZFRAMER_DEFAULT_MAX_SIZE (16ll * 1024 * 1024)
+
+class QoreZSock;
+
+// finds message boundaries in a byte stream
+class QoreZFramer {
+public:
+    DLLLOCAL virtual ~QoreZFramer() {
+    }
+
+    // finds the first complete message at the start of the data; returns 1 if a message was found, 0 if more data
+    // is needed and -1 if the data is invalid or the message exceeds max_size; if a message is found, consumed is
+    // the number of bytes used by the message including any framing, and the message data is the size bytes from
+    // offset start; scan is the offset up to which the data has already been searched without finding a message and
+    // is updated when 0 is returned
+    DLLLOCAL virtual int next(const char* data, size_t len, size_t& scan, size_t& consumed, size_t& start,
+            size_t& size) const = 0;
+
+    // returns the framer type name
+    DLLLOCAL virtual const char* getType() const = 0;
+
+    // creates a framer from a ZmqFramerOptions hash; returns nullptr for error (exception raised)
+    DLLLOCAL static QoreZFramer* create(const QoreHashNode* opts, int64& max_size, ExceptionSink* xsink);
+
+protected:
+    // the maximum message size
+    int64 max_size;
+
+    DLLLOCAL QoreZFramer(int64 max_size) : max_size(max_size) {
+    }
+};
+
+// reassembles the byte stream of each connection of a STREAM socket and splits it into messages; not thread-safe,
+// the object is only used by the thread that owns the socket
+class QoreZStreamFramer {
+public:
+    // takes ownership of the framer
+    DLLLOCAL QoreZStreamFramer(QoreZFramer* framer, int64 max_size) : framer(framer), max_size(max_size) {
+    }
+
+    DLLLOCAL ~QoreZStreamFramer();
+
+    // reads all data available on the socket without blocking until at least max messages and events are ready;
+    // returns -1 for error (exception raised), 0 for OK
+    DLLLOCAL int fill(QoreZSock& sock, size_t max, ExceptionSink* xsink);
+
+    // returns the next ready message or event as a ZmqStreamMessage hash or nullptr if none is ready
+    DLLLOCAL QoreHashNode* pop(ExceptionSink* xsink);
+
+    DLLLOCAL bool empty() const {
+        return ready.empty();
+    }
+
+    // returns a ZmqFramerInfo hash
+    DLLLOCAL QoreHashNode* getInfo(ExceptionSink* xsink) const;
+
+private:
+    // the state of a connection
+    struct Conn {
+        // data received that does not yet form a complete message
+        std::string buf;
+        // the offset in buf up to which no message boundary was found
+        size_t scan = 0;
+        // set when the connection has been closed due to an error
+        bool closed = false;
+    };
+
+    // a message or event ready to be returned
+    struct Item {
+        std::string id;
+        const char* event;
+        // the message data for "message" events
+        BinaryNode* data;
+    };
+
+    std::unique_ptr<QoreZFramer> framer;
+    // the maximum size of a message and of the data buffered for a connection
+    int64 max_size;
+
+    // connections by identity
+    std::unordered_map<std::string, Conn> conns;
+    // messages and events ready to be returned
+    std::deque<Item> ready;
+
+    int64 messages = 0;
+    int64 errors = 0;
+
+    // processes data received on a connection; returns -1 if the data is invalid
+    DLLLOCAL int process(const std::string& id, Conn& c, const char* data, size_t len);
+
+    // queues all complete messages at the start of the data and returns the number of bytes consumed or -1 if the
+    // data is invalid
+    DLLLOCAL int64 extract(const std::string& id, Conn& c, const char* data, size_t len);
+};
+
+#endif // _QORE_ZMQ_QOREZFRAMER_H
@@ -0,0 +1,129 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QoreZLvc.cpp defines the last-value cache for XPUB sockets */
+/*
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "QoreZLvc.h"
+
+QoreZLvc::QoreZLvc(const QoreHashNode* opts, ExceptionSink* xsink) : max_topics(ZLVC_DEFAULT_MAX_TOPICS),
+        max_bytes(ZLVC_DEFAULT_MAX_BYTES) {
+    if (opts) {
+        QoreValue v = opts->getKeyValue("max_topics");
+        if (!v.isNothing())
+            max_topics = v.getAsBigInt();
+        v = opts->getKeyValue("max_bytes");
+        if (!v.isNothing())
+            max_bytes = v.getAsBigInt();
+    }
+
+    if (max_topics < 1) {
+        xsink->raiseException("ZSOCKET-LVC-ERROR", "invalid maximum number of topics " QLLD "; the value must be "
+            "positive", max_topics);
+        return;
+    }
+    if (max_bytes < 1) {
+        xsink->raiseException("ZSOCKET-LVC-ERROR", "invalid maximum cache size " QLLD "; the value must be "
+            "positive", max_bytes);
+        return;
+    }
+}
+
+void QoreZLvc::update(const zmq_frame_vec_t& frames) {
+    assert(!frames.empty());
+    ++updates;
+
+    // the topic is stored as the key and as the first frame of the message
+    int64 cost = frames[0].second;
+    for (auto& f : frames)
+        cost += f.second;
+
+    std::string topic(frames[0].first, frames[0].second);
+    lvc_map_t::iterator i = entries.find(topic);
+    if (i == entries.end()) {
+        // messages larger than the cache are not cached
+        if (cost > max_bytes)
+            return;
+        evict(cost, true);
+        i = entries.emplace(std::move(topic), Entry()).first;
+        lru.push_back(&i->first);
+        i->second.pos = std::prev(lru.end());
+    } else {
+        // the previous value is removed in any case so that an outdated value is never replayed
+        if (cost > max_bytes) {
+            remove(i);
+            return;
+        }
+        bytes -= i->second.cost;
+        lru.splice(lru.end(), lru, i->second.pos);
+        evict(cost, false);
+    }
+
+    Entry& e = i->second;
+    e.data.clear();
+    e.sizes.clear();
+    for (auto& f : frames) {
+        e.data.append(f.first, f.second);
+        e.sizes.push_back(f.second);
+    }
+    e.cost = cost;
+    bytes += cost;
+}
+
+const QoreZLvc::Entry* QoreZLvc::get(const char* topic, size_t len) const {
+    lvc_map_t::const_iterator i = entries.find(std::string(topic, len));
+    return i == entries.end() ? nullptr : &i->second;
+}
+
+void QoreZLvc::match(const char* prefix, size_t len, std::vector<const Entry*>& rv) const {
+    // all topics with the given prefix follow the prefix itself in the ordered map
+    for (lvc_map_t::const_iterator i = entries.lower_bound(std::string(prefix, len)), e = entries.end(); i != e;
+        ++i) {
+        if (i->first.compare(0, len, prefix, len))
+            break;
+        rv.push_back(&i->second);
+    }
+}
+
+void QoreZLvc::evict(int64 cost, bool new_topic) {
+    // the entry being updated is always at the back of the list and is never evicted
+    while (!lru.empty() && (bytes + cost > max_bytes || (new_topic && (int64)entries.size() >= max_topics))) {
+        remove(entries.find(*lru.front()));
+        ++evicted;
+    }
+}
+
+void QoreZLvc::remove(lvc_map_t::iterator i) {
+    bytes -= i->second.cost;
+    lru.erase(i->second.pos);
+    entries.erase(i);
+}
+
+QoreHashNode* QoreZLvc::getInfo(ExceptionSink* xsink) const {
+    ReferenceHolder<QoreHashNode> h(new QoreHashNode(hashdeclZmqLvcInfo, xsink), xsink);
+    h->setKeyValue("topics", (int64)entries.size(), xsink);
+    h->setKeyValue("bytes", bytes, xsink);
+    h->setKeyValue("max_topics", max_topics, xsink);
+    h->setKeyValue("max_bytes", max_bytes, xsink);
+    h->setKeyValue("updates", updates, xsink);
+    h->setKeyValue("replays", replays, xsink);
+    h->setKeyValue("replayed", replayed, xsink);
+    h->setKeyValue("evicted", evicted, xsink);
+    return h.release();
+}
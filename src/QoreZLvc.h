@@ -0,0 +1,100 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QoreZLvc.h defines the last-value cache for XPUB sockets */
+/*
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_ZMQ_QOREZLVC_H
+
+#define _QORE_ZMQ_QOREZLVC_H
+
+#include "zmq-module.h"
+#include "QoreZSpool.h"
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+// default option values
+#define ZLVC_DEFAULT_MAX_TOPICS 10000
+#define ZLVC_DEFAULT_MAX_BYTES (64ll * 1024 * 1024)
+
+// keeps the last message sent for each topic, where the topic is the first frame of the message; when the cache is
+// full, the topics updated least recently are evicted; not thread-safe, the cache is only used by the thread that
+// owns the socket
+class QoreZLvc {
+public:
+    struct Entry {
+        // the data of all frames of the message, including the topic frame
+        std::string data;
+        // the size of each frame
+        std::vector<size_t> sizes;
+        // the memory accounted for the entry
+        int64 cost;
+        // the position of the entry in the eviction order
+        std::list<const std::string*>::iterator pos;
+    };
+
+    DLLLOCAL QoreZLvc(const QoreHashNode* opts, ExceptionSink* xsink);
+
+    // stores a copy of the message as the last value for its topic
+    DLLLOCAL void update(const zmq_frame_vec_t& frames);
+
+    // returns the cached message for the given topic or nullptr if there is none
+    DLLLOCAL const Entry* get(const char* topic, size_t len) const;
+
+    // returns the cached messages for all topics starting with the given prefix in topic order
+    DLLLOCAL void match(const char* prefix, size_t len, std::vector<const Entry*>& rv) const;
+
+    // records a subscription for which the given number of messages were replayed
+    DLLLOCAL void addReplay(int64 n) {
+        ++replays;
+        replayed += n;
+    }
+
+    // returns a ZmqLvcInfo hash
+    DLLLOCAL QoreHashNode* getInfo(ExceptionSink* xsink) const;
+
+private:
+    typedef std::map<std::string, Entry> lvc_map_t;
+
+    // the maximum number of topics
+    int64 max_topics;
+    // the maximum number of bytes of cached data
+    int64 max_bytes;
+
+    // cached messages; ordered by topic for prefix matching
+    lvc_map_t entries;
+    // topics in the order they were last updated; the front is evicted first
+    std::list<const std::string*> lru;
+
+    int64 bytes = 0;
+    int64 updates = 0;
+    int64 replays = 0;
+    int64 replayed = 0;
+    int64 evicted = 0;
+
+    // evicts topics until a message of the given size fits in the cache
+    DLLLOCAL void evict(int64 cost, bool new_topic);
+
+    DLLLOCAL void remove(lvc_map_t::iterator i);
+};
+
+#endif // _QORE_ZMQ_QOREZLVC_H
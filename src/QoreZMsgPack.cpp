@@ -0,0 +1,755 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QoreZMsgPack.cpp defines the msgpack-compatible binary codec for Qore values */
+/*
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "QoreZMsgPack.h"
+
+#include <string>
+
+#include <string.h>
+
+// the payload size of relative date/time extension values
+#define ZMQ_MSGPACK_RELDATE_SIZE 28
+
+// returns true if strings in the given encoding can be written without conversion
+static bool zmq_msgpack_is_utf8(const QoreEncoding* enc) {
+    return enc == QCS_UTF8 || enc == QCS_USASCII;
+}
+
+// returns the size of the header for a string or binary value with the given length
+static int64 zmq_msgpack_data_header_size(size_t len, bool str) {
+    if (str && len < 32)
+        return 1;
+    if (len < 0x100)
+        return 2;
+    if (len < 0x10000)
+        return 3;
+    return 5;
+}
+
+// returns the size of the header for an array or map with the given number of elements
+static int64 zmq_msgpack_container_header_size(size_t len) {
+    if (len < 16)
+        return 1;
+    if (len < 0x10000)
+        return 3;
+    return 5;
+}
+
+// returns the size of the header for an extension value with the given payload size
+static int64 zmq_msgpack_ext_header_size(size_t len) {
+    switch (len) {
+        case 1:
+        case 2:
+        case 4:
+        case 8:
+        case 16:
+            return 2;
+    }
+    if (len < 0x100)
+        return 3;
+    if (len < 0x10000)
+        return 4;
+    return 6;
+}
+
+static int64 zmq_msgpack_int_size(int64 i) {
+    if (i >= 0) {
+        if (i < 0x80)
+            return 1;
+        if (i < 0x100)
+            return 2;
+        if (i < 0x10000)
+            return 3;
+        if (i < 0x100000000ll)
+            return 5;
+        return 9;
+    }
+    if (i >= -32)
+        return 1;
+    if (i >= -0x80)
+        return 2;
+    if (i >= -0x8000)
+        return 3;
+    if (i >= -0x80000000ll)
+        return 5;
+    return 9;
+}
+
+// returns the size of the payload of a timestamp extension value
+static int64 zmq_msgpack_timestamp_size(int64 secs, int us) {
+    if (secs >= 0 && !(secs >> 34))
+        return (!us && !(secs >> 32)) ? 4 : 8;
+    return 12;
+}
+
+static unsigned char* zmq_msgpack_put16(unsigned char* p, uint16_t v) {
+    *p++ = (unsigned char)(v >> 8);
+    *p++ = (unsigned char)v;
+    return p;
+}
+
+static unsigned char* zmq_msgpack_put32(unsigned char* p, uint32_t v) {
+    *p++ = (unsigned char)(v >> 24);
+    *p++ = (unsigned char)(v >> 16);
+    *p++ = (unsigned char)(v >> 8);
+    *p++ = (unsigned char)v;
+    return p;
+}
+
+static unsigned char* zmq_msgpack_put64(unsigned char* p, uint64_t v) {
+    p = zmq_msgpack_put32(p, (uint32_t)(v >> 32));
+    return zmq_msgpack_put32(p, (uint32_t)v);
+}
+
+static unsigned char* zmq_msgpack_write_int(unsigned char* p, int64 i) {
+    if (i >= 0) {
+        if (i < 0x80) {
+            *p++ = (unsigned char)i;
+        } else if (i < 0x100) {
+            *p++ = 0xcc;
+            *p++ = (unsigned char)i;
+        } else if (i < 0x10000) {
+            *p++ = 0xcd;
+            p = zmq_msgpack_put16(p, (uint16_t)i);
+        } else if (i < 0x100000000ll) {
+            *p++ = 0xce;
+            p = zmq_msgpack_put32(p, (uint32_t)i);
+        } else {
+            *p++ = 0xcf;
+            p = zmq_msgpack_put64(p, (uint64_t)i);
+        }
+        return p;
+    }
+    if (i >= -32) {
+        *p++ = (unsigned char)(int8_t)i;
+    } else if (i >= -0x80) {
+        *p++ = 0xd0;
+        *p++ = (unsigned char)(int8_t)i;
+    } else if (i >= -0x8000) {
+        *p++ = 0xd1;
+        p = zmq_msgpack_put16(p, (uint16_t)(int16_t)i);
+    } else if (i >= -0x80000000ll) {
+        *p++ = 0xd2;
+        p = zmq_msgpack_put32(p, (uint32_t)(int32_t)i);
+    } else {
+        *p++ = 0xd3;
+        p = zmq_msgpack_put64(p, (uint64_t)i);
+    }
+    return p;
+}
+
+static unsigned char* zmq_msgpack_write_data_header(unsigned char* p, size_t len, bool str) {
+    if (str && len < 32) {
+        *p++ = 0xa0 | (unsigned char)len;
+    } else if (len < 0x100) {
+        *p++ = str ? 0xd9 : 0xc4;
+        *p++ = (unsigned char)len;
+    } else if (len < 0x10000) {
+        *p++ = str ? 0xda : 0xc5;
+        p = zmq_msgpack_put16(p, (uint16_t)len);
+    } else {
+        *p++ = str ? 0xdb : 0xc6;
+        p = zmq_msgpack_put32(p, (uint32_t)len);
+    }
+    return p;
+}
+
+static unsigned char* zmq_msgpack_write_container_header(unsigned char* p, size_t len, bool map) {
+    if (len < 16) {
+        *p++ = (map ? 0x80 : 0x90) | (unsigned char)len;
+    } else if (len < 0x10000) {
+        *p++ = map ? 0xde : 0xdc;
+        p = zmq_msgpack_put16(p, (uint16_t)len);
+    } else {
+        *p++ = map ? 0xdf : 0xdd;
+        p = zmq_msgpack_put32(p, (uint32_t)len);
+    }
+    return p;
+}
+
+static unsigned char* zmq_msgpack_write_ext_header(unsigned char* p, size_t len, int type) {
+    switch (len) {
+        case 1: *p++ = 0xd4; break;
+        case 2: *p++ = 0xd5; break;
+        case 4: *p++ = 0xd6; break;
+        case 8: *p++ = 0xd7; break;
+        case 16: *p++ = 0xd8; break;
+        default:
+            if (len < 0x100) {
+                *p++ = 0xc7;
+                *p++ = (unsigned char)len;
+            } else if (len < 0x10000) {
+                *p++ = 0xc8;
+                p = zmq_msgpack_put16(p, (uint16_t)len);
+            } else {
+                *p++ = 0xc9;
+                p = zmq_msgpack_put32(p, (uint32_t)len);
+            }
+            break;
+    }
+    *p++ = (unsigned char)(int8_t)type;
+    return p;
+}
+
+static void zmq_msgpack_number_string(const QoreNumberNode* n, QoreString& str) {
+    n->toString(str, QORE_NF_RAW);
+}
+
+QoreZMsgPack::~QoreZMsgPack() {
+    for (auto& i : conv) {
+        delete i;
+    }
+}
+
+int64 QoreZMsgPack::prepare(const QoreValue& v, ExceptionSink* xsink) {
+    return getSize(v, 0, xsink);
+}
+
+unsigned char* QoreZMsgPack::write(const QoreValue& v, unsigned char* buf) {
+    conv_pos = 0;
+    return writeValue(v, buf);
+}
+
+zframe_t* QoreZMsgPack::encodeFrame(const QoreValue& v, ExceptionSink* xsink) {
+    int64 size = prepare(v, xsink);
+    if (size < 0)
+        return nullptr;
+
+    // allocate the frame without initializing its data and serialize the value directly into it
+    zframe_t* frame = zframe_new(nullptr, size);
+    if (!frame) {
+        xsink->outOfMemory();
+        return nullptr;
+    }
+    write(v, zframe_data(frame));
+    return frame;
+}
+
+int64 QoreZMsgPack::getStringSize(const QoreString* str, ExceptionSink* xsink) {
+    if (!zmq_msgpack_is_utf8(str->getEncoding())) {
+        QoreString* utf8 = str->convertEncoding(QCS_UTF8, xsink);
+        if (!utf8)
+            return -1;
+        conv.push_back(utf8);
+        str = utf8;
+    }
+    if (str->size() > 0xffffffffull) {
+        xsink->raiseException(err, "cannot encode a string of %lld bytes; the maximum size is 4GB",
+            (int64)str->size());
+        return -1;
+    }
+    return zmq_msgpack_data_header_size(str->size(), true) + str->size();
+}
+
+int64 QoreZMsgPack::getKeySize(const char* key, ExceptionSink* xsink) {
+    if (!zmq_msgpack_is_utf8(QCS_DEFAULT)) {
+        QoreString tmp(key, QCS_DEFAULT);
+        return getStringSize(&tmp, xsink);
+    }
+    size_t len = strlen(key);
+    return zmq_msgpack_data_header_size(len, true) + len;
+}
+
+int64 QoreZMsgPack::getSize(const QoreValue& v, int depth, ExceptionSink* xsink) {
+    switch (v.getType()) {
+        case NT_NOTHING:
+        case NT_NULL:
+        case NT_BOOLEAN:
+            return 1;
+
+        case NT_INT:
+            return zmq_msgpack_int_size(v.getAsBigInt());
+
+        case NT_FLOAT:
+            return 9;
+
+        case NT_NUMBER: {
+            QoreString str;
+            zmq_msgpack_number_string(v.get<const QoreNumberNode>(), str);
+            return zmq_msgpack_ext_header_size(str.size()) + str.size();
+        }
+
+        case NT_STRING:
+            return getStringSize(v.get<const QoreStringNode>(), xsink);
+
+        case NT_BINARY: {
+            size_t len = v.get<const BinaryNode>()->size();
+            if (len > 0xffffffffull) {
+                xsink->raiseException(err, "cannot encode a binary value of %lld bytes; the maximum size is 4GB",
+                    (int64)len);
+                return -1;
+            }
+            return zmq_msgpack_data_header_size(len, false) + len;
+        }
+
+        case NT_DATE: {
+            const DateTimeNode* d = v.get<const DateTimeNode>();
+            if (d->isRelative())
+                return zmq_msgpack_ext_header_size(ZMQ_MSGPACK_RELDATE_SIZE) + ZMQ_MSGPACK_RELDATE_SIZE;
+            int64 len = zmq_msgpack_timestamp_size(d->getEpochSecondsUTC(), d->getMicrosecond());
+            return zmq_msgpack_ext_header_size(len) + len;
+        }
+
+        case NT_LIST: {
+            if (depth == ZMQ_MSGPACK_MAX_DEPTH) {
+                xsink->raiseException(err, "cannot encode values nested more than %d levels deep",
+                    ZMQ_MSGPACK_MAX_DEPTH);
+                return -1;
+            }
+            const QoreListNode* l = v.get<const QoreListNode>();
+            int64 size = zmq_msgpack_container_header_size(l->size());
+            ConstListIterator li(l);
+            while (li.next()) {
+                int64 len = getSize(li.getValue(), depth + 1, xsink);
+                if (len < 0)
+                    return -1;
+                size += len;
+            }
+            return size;
+        }
+
+        case NT_HASH: {
+            if (depth == ZMQ_MSGPACK_MAX_DEPTH) {
+                xsink->raiseException(err, "cannot encode values nested more than %d levels deep",
+                    ZMQ_MSGPACK_MAX_DEPTH);
+                return -1;
+            }
+            const QoreHashNode* h = v.get<const QoreHashNode>();
+            int64 size = zmq_msgpack_container_header_size(h->size());
+            ConstHashIterator hi(h);
+            while (hi.next()) {
+                int64 len = getKeySize(hi.getKey(), xsink);
+                if (len < 0)
+                    return -1;
+                size += len;
+                len = getSize(hi.get(), depth + 1, xsink);
+                if (len < 0)
+                    return -1;
+                size += len;
+            }
+            return size;
+        }
+
+        default:
+            break;
+    }
+
+    xsink->raiseException(err, "cannot encode a value of type '%s'; only strings, binaries, numeric, boolean and "
+        "date/time values and lists and hashes of such values can be encoded", v.getTypeName());
+    return -1;
+}
+
+unsigned char* QoreZMsgPack::writeString(const QoreString* str, unsigned char* p) {
+    if (!zmq_msgpack_is_utf8(str->getEncoding()))
+        str = conv[conv_pos++];
+    p = zmq_msgpack_write_data_header(p, str->size(), true);
+    memcpy(p, str->c_str(), str->size());
+    return p + str->size();
+}
+
+unsigned char* QoreZMsgPack::writeKey(const char* key, unsigned char* p) {
+    if (!zmq_msgpack_is_utf8(QCS_DEFAULT)) {
+        const QoreString* str = conv[conv_pos++];
+        p = zmq_msgpack_write_data_header(p, str->size(), true);
+        memcpy(p, str->c_str(), str->size());
+        return p + str->size();
+    }
+    size_t len = strlen(key);
+    p = zmq_msgpack_write_data_header(p, len, true);
+    memcpy(p, key, len);
+    return p + len;
+}
+
+unsigned char* QoreZMsgPack::writeValue(const QoreValue& v, unsigned char* p) {
+    switch (v.getType()) {
+        case NT_NOTHING:
+        case NT_NULL:
+            *p++ = 0xc0;
+            return p;
+
+        case NT_BOOLEAN:
+            *p++ = v.getAsBool() ? 0xc3 : 0xc2;
+            return p;
+
+        case NT_INT:
+            return zmq_msgpack_write_int(p, v.getAsBigInt());
+
+        case NT_FLOAT: {
+            double f = v.getAsFloat();
+            uint64_t u;
+            memcpy(&u, &f, sizeof u);
+            *p++ = 0xcb;
+            return zmq_msgpack_put64(p, u);
+        }
+
+        case NT_NUMBER: {
+            QoreString str;
+            zmq_msgpack_number_string(v.get<const QoreNumberNode>(), str);
+            p = zmq_msgpack_write_ext_header(p, str.size(), ZMQ_MSGPACK_EXT_NUMBER);
+            memcpy(p, str.c_str(), str.size());
+            return p + str.size();
+        }
+
+        case NT_STRING:
+            return writeString(v.get<const QoreStringNode>(), p);
+
+        case NT_BINARY: {
+            const BinaryNode* b = v.get<const BinaryNode>();
+            p = zmq_msgpack_write_data_header(p, b->size(), false);
+            memcpy(p, b->getPtr(), b->size());
+            return p + b->size();
+        }
+
+        case NT_DATE: {
+            const DateTimeNode* d = v.get<const DateTimeNode>();
+            if (d->isRelative()) {
+                p = zmq_msgpack_write_ext_header(p, ZMQ_MSGPACK_RELDATE_SIZE, ZMQ_MSGPACK_EXT_RELDATE);
+                p = zmq_msgpack_put32(p, (uint32_t)d->getYear());
+                p = zmq_msgpack_put32(p, (uint32_t)d->getMonth());
+                p = zmq_msgpack_put32(p, (uint32_t)d->getDay());
+                p = zmq_msgpack_put32(p, (uint32_t)d->getHour());
+                p = zmq_msgpack_put32(p, (uint32_t)d->getMinute());
+                p = zmq_msgpack_put32(p, (uint32_t)d->getSecond());
+                return zmq_msgpack_put32(p, (uint32_t)d->getMicrosecond());
+            }
+
+            int64 secs = d->getEpochSecondsUTC();
+            int us = d->getMicrosecond();
+            int64 len = zmq_msgpack_timestamp_size(secs, us);
+            p = zmq_msgpack_write_ext_header(p, len, ZMQ_MSGPACK_EXT_TIMESTAMP);
+            uint32_t nsecs = (uint32_t)us * 1000;
+            switch (len) {
+                case 4:
+                    return zmq_msgpack_put32(p, (uint32_t)secs);
+                case 8:
+                    return zmq_msgpack_put64(p, ((uint64_t)nsecs << 34) | (uint64_t)secs);
+                default:
+                    p = zmq_msgpack_put32(p, nsecs);
+                    return zmq_msgpack_put64(p, (uint64_t)secs);
+            }
+        }
+
+        case NT_LIST: {
+            const QoreListNode* l = v.get<const QoreListNode>();
+            p = zmq_msgpack_write_container_header(p, l->size(), false);
+            ConstListIterator li(l);
+            while (li.next()) {
+                p = writeValue(li.getValue(), p);
+            }
+            return p;
+        }
+
+        case NT_HASH: {
+            const QoreHashNode* h = v.get<const QoreHashNode>();
+            p = zmq_msgpack_write_container_header(p, h->size(), true);
+            ConstHashIterator hi(h);
+            while (hi.next()) {
+                p = writeKey(hi.getKey(), p);
+                p = writeValue(hi.get(), p);
+            }
+            return p;
+        }
+
+        default:
+            // not reached; rejected by prepare()
+            assert(false);
+            break;
+    }
+    return p;
+}
+
+namespace {
+// decodes msgpack data from a buffer with bounds checking
+class QoreZMsgPackDecoder {
+public:
+    DLLLOCAL QoreZMsgPackDecoder(const void* data, size_t len, const char* err, ExceptionSink* xsink)
+            : begin(static_cast<const unsigned char*>(data)), p(begin), end(begin + len), err(err), xsink(xsink) {
+    }
+
+    DLLLOCAL QoreValue decode() {
+        ValueHolder rv(decodeValue(0), xsink);
+        if (*xsink)
+            return QoreValue();
+        if (p != end) {
+            xsink->raiseException(err, "%lld unexpected trailing byte(s) after the encoded value", (int64)(end - p));
+            return QoreValue();
+        }
+        return rv.release();
+    }
+
+private:
+    const unsigned char* begin;
+    const unsigned char* p;
+    const unsigned char* end;
+    const char* err;
+    ExceptionSink* xsink;
+
+    DLLLOCAL int need(size_t len) {
+        if ((size_t)(end - p) < len) {
+            xsink->raiseException(err, "truncated data: %lld byte(s) required at offset %lld, but only %lld "
+                "available", (int64)len, (int64)(p - begin), (int64)(end - p));
+            return -1;
+        }
+        return 0;
+    }
+
+    DLLLOCAL uint64_t get(size_t bytes) {
+        uint64_t v = 0;
+        for (size_t i = 0; i < bytes; ++i) {
+            v = (v << 8) | *p++;
+        }
+        return v;
+    }
+
+    // returns the length of a value with a length prefix of the given size, -1 = error (exception raised)
+    DLLLOCAL int64 getLength(size_t bytes) {
+        if (need(bytes))
+            return -1;
+        return (int64)get(bytes);
+    }
+
+    DLLLOCAL QoreValue decodeValue(int depth) {
+        if (need(1))
+            return QoreValue();
+        unsigned char c = *p++;
+
+        // positive fixint
+        if (c < 0x80)
+            return (int64)c;
+        // fixmap
+        if (c < 0x90)
+            return decodeMap(c & 0x0f, depth);
+        // fixarray
+        if (c < 0xa0)
+            return decodeArray(c & 0x0f, depth);
+        // fixstr
+        if (c < 0xc0)
+            return decodeString(c & 0x1f);
+        // negative fixint
+        if (c >= 0xe0)
+            return (int64)(int8_t)c;
+
+        switch (c) {
+            case 0xc0: return QoreValue();
+            case 0xc2: return false;
+            case 0xc3: return true;
+
+            case 0xc4: return decodeBinary(getLength(1));
+            case 0xc5: return decodeBinary(getLength(2));
+            case 0xc6: return decodeBinary(getLength(4));
+
+            case 0xc7: return decodeExt(getLength(1));
+            case 0xc8: return decodeExt(getLength(2));
+            case 0xc9: return decodeExt(getLength(4));
+
+            case 0xca: {
+                if (need(4))
+                    return QoreValue();
+                uint32_t u = (uint32_t)get(4);
+                float f;
+                memcpy(&f, &u, sizeof f);
+                return (double)f;
+            }
+            case 0xcb: {
+                if (need(8))
+                    return QoreValue();
+                uint64_t u = get(8);
+                double f;
+                memcpy(&f, &u, sizeof f);
+                return f;
+            }
+
+            case 0xcc: return need(1) ? QoreValue() : QoreValue((int64)get(1));
+            case 0xcd: return need(2) ? QoreValue() : QoreValue((int64)get(2));
+            case 0xce: return need(4) ? QoreValue() : QoreValue((int64)get(4));
+            case 0xcf: {
+                if (need(8))
+                    return QoreValue();
+                uint64_t u = get(8);
+                if (u <= (uint64_t)0x7fffffffffffffffull)
+                    return (int64)u;
+                // values that do not fit in a Qore integer are returned as arbitrary-precision numbers
+                std::string str = std::to_string(u);
+                return new QoreNumberNode(str.c_str());
+            }
+
+            case 0xd0: return need(1) ? QoreValue() : QoreValue((int64)(int8_t)get(1));
+            case 0xd1: return need(2) ? QoreValue() : QoreValue((int64)(int16_t)get(2));
+            case 0xd2: return need(4) ? QoreValue() : QoreValue((int64)(int32_t)get(4));
+            case 0xd3: return need(8) ? QoreValue() : QoreValue((int64)get(8));
+
+            case 0xd4: return decodeExt(1);
+            case 0xd5: return decodeExt(2);
+            case 0xd6: return decodeExt(4);
+            case 0xd7: return decodeExt(8);
+            case 0xd8: return decodeExt(16);
+
+            case 0xd9: return decodeString(getLength(1));
+            case 0xda: return decodeString(getLength(2));
+            case 0xdb: return decodeString(getLength(4));
+
+            case 0xdc: return decodeArray(getLength(2), depth);
+            case 0xdd: return decodeArray(getLength(4), depth);
+            case 0xde: return decodeMap(getLength(2), depth);
+            case 0xdf: return decodeMap(getLength(4), depth);
+
+            default:
+                break;
+        }
+
+        xsink->raiseException(err, "invalid type byte 0x%02x at offset %lld", (int)c, (int64)(p - 1 - begin));
+        return QoreValue();
+    }
+
+    DLLLOCAL QoreValue decodeString(int64 len) {
+        if (len < 0 || need(len))
+            return QoreValue();
+        QoreStringNode* str = new QoreStringNode((const char*)p, (size_t)len, QCS_UTF8);
+        p += len;
+        return str;
+    }
+
+    DLLLOCAL QoreValue decodeBinary(int64 len) {
+        if (len < 0 || need(len))
+            return QoreValue();
+        BinaryNode* b = new BinaryNode;
+        b->append(p, (size_t)len);
+        p += len;
+        return b;
+    }
+
+    DLLLOCAL QoreValue decodeArray(int64 len, int depth) {
+        if (len < 0 || checkDepth(depth))
+            return QoreValue();
+        ReferenceHolder<QoreListNode> l(new QoreListNode(autoTypeInfo), xsink);
+        for (int64 i = 0; i < len; ++i) {
+            ValueHolder v(decodeValue(depth + 1), xsink);
+            if (*xsink)
+                return QoreValue();
+            l->push(v.release(), xsink);
+        }
+        return l.release();
+    }
+
+    DLLLOCAL QoreValue decodeMap(int64 len, int depth) {
+        if (len < 0 || checkDepth(depth))
+            return QoreValue();
+        ReferenceHolder<QoreHashNode> h(new QoreHashNode(autoTypeInfo), xsink);
+        for (int64 i = 0; i < len; ++i) {
+            ValueHolder k(decodeValue(depth + 1), xsink);
+            if (*xsink)
+                return QoreValue();
+            std::string key;
+            switch (k->getType()) {
+                case NT_STRING: {
+                    const QoreStringNode* str = k->get<const QoreStringNode>();
+                    key.assign(str->c_str(), str->size());
+                    break;
+                }
+                case NT_INT:
+                    key = std::to_string(k->getAsBigInt());
+                    break;
+                default:
+                    xsink->raiseException(err, "invalid map key of type '%s'; only string and integer keys are "
+                        "supported", k->getTypeName());
+                    return QoreValue();
+            }
+            ValueHolder v(decodeValue(depth + 1), xsink);
+            if (*xsink)
+                return QoreValue();
+            h->setKeyValue(key.c_str(), v.release(), xsink);
+        }
+        return h.release();
+    }
+
+    DLLLOCAL QoreValue decodeExt(int64 len) {
+        if (len < 0 || need(len + 1))
+            return QoreValue();
+        int type = (int8_t)*p++;
+
+        switch (type) {
+            case ZMQ_MSGPACK_EXT_TIMESTAMP: {
+                int64 secs;
+                uint32_t nsecs;
+                switch (len) {
+                    case 4:
+                        secs = (int64)get(4);
+                        nsecs = 0;
+                        break;
+                    case 8: {
+                        uint64_t v = get(8);
+                        nsecs = (uint32_t)(v >> 34);
+                        secs = (int64)(v & 0x3ffffffffull);
+                        break;
+                    }
+                    case 12:
+                        nsecs = (uint32_t)get(4);
+                        secs = (int64)get(8);
+                        break;
+                    default:
+                        xsink->raiseException(err, "invalid timestamp extension size %lld", len);
+                        return QoreValue();
+                }
+                return DateTimeNode::makeAbsolute(currentTZ(), secs, nsecs / 1000);
+            }
+
+            case ZMQ_MSGPACK_EXT_NUMBER: {
+                std::string str((const char*)p, (size_t)len);
+                p += len;
+                return new QoreNumberNode(str.c_str());
+            }
+
+            case ZMQ_MSGPACK_EXT_RELDATE: {
+                if (len != ZMQ_MSGPACK_RELDATE_SIZE) {
+                    xsink->raiseException(err, "invalid relative date extension size %lld", len);
+                    return QoreValue();
+                }
+                int f[7];
+                for (int i = 0; i < 7; ++i) {
+                    f[i] = (int32_t)get(4);
+                }
+                return DateTimeNode::makeRelative(f[0], f[1], f[2], f[3], f[4], f[5], f[6]);
+            }
+
+            default:
+                break;
+        }
+
+        xsink->raiseException(err, "unsupported extension type %d", type);
+        return QoreValue();
+    }
+
+    DLLLOCAL int checkDepth(int depth) {
+        if (depth == ZMQ_MSGPACK_MAX_DEPTH) {
+            xsink->raiseException(err, "cannot decode values nested more than %d levels deep",
+                ZMQ_MSGPACK_MAX_DEPTH);
+            return -1;
+        }
+        return 0;
+    }
+};
+}
+
+QoreValue QoreZMsgPack::decode(const void* data, size_t len, const char* err, ExceptionSink* xsink) {
+    QoreZMsgPackDecoder dec(data, len, err, xsink);
+    return dec.decode();
+}
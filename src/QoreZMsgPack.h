@@ -0,0 +1,87 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QoreZMsgPack.h defines the msgpack-compatible binary codec for Qore values */
+/*
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_ZMQ_QOREZMSGPACK_H
+
+#define _QORE_ZMQ_QOREZMSGPACK_H
+
+#include "zmq-module.h"
+
+#include <czmq.h>
+
+#include <vector>
+
+// msgpack extension type for arbitrary-precision numbers; the payload is the number's string representation
+#define ZMQ_MSGPACK_EXT_NUMBER 1
+// msgpack extension type for relative date/time values; the payload is 7 big-endian 32-bit integers
+#define ZMQ_MSGPACK_EXT_RELDATE 2
+// the standard msgpack timestamp extension type used for absolute date/time values
+#define ZMQ_MSGPACK_EXT_TIMESTAMP -1
+
+// the maximum container nesting depth accepted when encoding and decoding
+#define ZMQ_MSGPACK_MAX_DEPTH 512
+
+// encodes Qore values in two passes: prepare() calculates the encoded size, then write() serializes the value
+// directly into a buffer of that size, such as the data buffer of a ZeroMQ message
+class QoreZMsgPack {
+public:
+    DLLLOCAL QoreZMsgPack(const char* err) : err(err) {
+    }
+
+    DLLLOCAL ~QoreZMsgPack();
+
+    // returns the encoded size of the value, -1 = error (exception raised)
+    DLLLOCAL int64 prepare(const QoreValue& v, ExceptionSink* xsink);
+
+    // writes the value given to prepare() to the buffer, which must be at least as large as the size returned by
+    // prepare(); returns a pointer to the byte after the encoded value
+    DLLLOCAL unsigned char* write(const QoreValue& v, unsigned char* buf);
+
+    // returns a new frame with the encoded value or nullptr for error (exception raised)
+    DLLLOCAL zframe_t* encodeFrame(const QoreValue& v, ExceptionSink* xsink);
+
+    // decodes a single value, which must span the entire buffer; returns an empty value for error (exception raised)
+    DLLLOCAL static QoreValue decode(const void* data, size_t len, const char* err, ExceptionSink* xsink);
+
+private:
+    // the exception code for encoding errors
+    const char* err;
+    // strings converted to UTF-8 in prepare() in the order they are written in write()
+    std::vector<QoreString*> conv;
+    size_t conv_pos = 0;
+
+    DLLLOCAL int64 getSize(const QoreValue& v, int depth, ExceptionSink* xsink);
+
+    // returns the size of a string, converting it to UTF-8 if necessary, -1 = error (exception raised)
+    DLLLOCAL int64 getStringSize(const QoreString* str, ExceptionSink* xsink);
+
+    // returns the size of a hash key, converting it to UTF-8 if necessary, -1 = error (exception raised)
+    DLLLOCAL int64 getKeySize(const char* key, ExceptionSink* xsink);
+
+    DLLLOCAL unsigned char* writeValue(const QoreValue& v, unsigned char* p);
+
+    DLLLOCAL unsigned char* writeString(const QoreString* str, unsigned char* p);
+
+    DLLLOCAL unsigned char* writeKey(const char* key, unsigned char* p);
+};
+
+#endif // _QORE_ZMQ_QOREZMSGPACK_H
@@ -24,6 +24,7 @@
 
 #include "QC_ZSocket.h"
 
+#include <algorithm>
 #include <regex>
 #include <string>
 #include <vector>
@@ -35,6 +36,361 @@
 
 static std::regex url_port_regex("^tcp://.*:(\\d+|\\*)$", std::regex_constants::ECMAScript | std::regex_constants::icase | std::regex_constants::optimize);
 
+// releases the reference to the string or binary value backing a zero-copy message; called by libzmq (possibly in
+// one of its I/O threads) when the message buffer is no longer in use
+static void qore_zmq_free_value(void* data, void* hint) {
+    static_cast<SimpleQoreNode*>(hint)->deref();
+}
+
+// frees a buffer allocated with malloc() backing a message; called by libzmq when the message buffer is no longer in
+// use
+static void qore_zmq_free_buffer(void* data, void* hint) {
+    free(data);
+}
+
+int QoreZSock::sendFrame(const char* ptr, size_t len, int flags) {
+    if (!compress || !compress->needsEncoding(ptr, len)) {
+        while (true) {
+            int rc = zmq_send(sock, ptr, len, flags);
+            if (rc < 0 && errno == EINTR)
+                continue;
+            return rc;
+        }
+    }
+
+    // the frame is compressed into a new buffer that is handed over to the message without copying
+    size_t out_len;
+    char* buf = compress->encode(ptr, len, out_len);
+    if (!buf)
+        return -1;
+
+    zmq_msg_t msg;
+    if (zmq_msg_init_data(&msg, buf, out_len, qore_zmq_free_buffer, nullptr)) {
+        free(buf);
+        return -1;
+    }
+
+    while (true) {
+        int rc = zmq_msg_send(&msg, sock, flags);
+        if (rc < 0) {
+            if (errno == EINTR)
+                continue;
+            // the message is still owned by the caller after a failed send
+            int err = errno;
+            zmq_msg_close(&msg);
+            errno = err;
+        }
+        return rc;
+    }
+}
+
+int QoreZSock::decodeFrame(const void* data, size_t len, void*& out, size_t& out_len, ExceptionSink* xsink) {
+    if (!compress)
+        return 0;
+
+    // decompressed frames are subject to the socket's maximum message size
+    return compress->decode(data, len, max_msg_size, out, out_len, xsink);
+}
+
+int QoreZSock::decodeMsg(zmsg_t* msg, ExceptionSink* xsink) {
+    if (!compress)
+        return 0;
+
+    for (zframe_t* f = zmsg_first(msg); f; f = zmsg_next(msg)) {
+        void* out;
+        size_t out_len;
+        int rc = decodeFrame(zframe_data(f), zframe_size(f), out, out_len, xsink);
+        if (rc < 0)
+            return -1;
+        if (rc) {
+            zframe_reset(f, out, out_len);
+            free(out);
+        }
+    }
+    return 0;
+}
+
+int QoreZSock::sendData(const QoreValue& v, const char* ptr, size_t len, int flags) {
+    // compressed frames are always sent from a new buffer
+    if (zero_copy_threshold < 0 || !len || len < (size_t)zero_copy_threshold
+        || (compress && compress->needsEncoding(ptr, len))) {
+        return sendFrame(ptr, len, flags);
+    }
+
+    // the message holds a reference to the value until libzmq releases the buffer; Qore strings and binary objects
+    // are not modified in place while they have more than one reference, so the buffer remains valid
+    SimpleQoreNode* n = const_cast<SimpleQoreNode*>(static_cast<const SimpleQoreNode*>(v.getInternalNode()));
+    n->ref();
+
+    zmq_msg_t msg;
+    if (zmq_msg_init_data(&msg, const_cast<char*>(ptr), len, qore_zmq_free_value, n)) {
+        n->deref();
+        return -1;
+    }
+
+    while (true) {
+        int rc = zmq_msg_send(&msg, sock, flags);
+        if (rc < 0) {
+            if (errno == EINTR)
+                continue;
+            // the message is still owned by the caller after a failed send
+            int err = errno;
+            zmq_msg_close(&msg);
+            errno = err;
+        }
+        return rc;
+    }
+}
+
+int QoreZSock::sendSpooled(const zmq_frame_vec_t& in_frames, const char* meth, ExceptionSink* xsink) {
+    assert(spool);
+
+    // frames are compressed before they are sent or spooled
+    zmq_frame_vec_t encoded;
+    // frees the buffers of the encoded frames
+    struct EncodedBufferHolder {
+        std::vector<char*> v;
+        DLLLOCAL ~EncodedBufferHolder() {
+            for (char* p : v)
+                free(p);
+        }
+    } bufs;
+    if (compress) {
+        for (auto& i : in_frames) {
+            if (!compress->needsEncoding(i.first, i.second)) {
+                encoded.push_back(i);
+                continue;
+            }
+            size_t out_len;
+            char* buf = compress->encode(i.first, i.second, out_len);
+            if (!buf) {
+                xsink->outOfMemory();
+                return -1;
+            }
+            bufs.v.push_back(buf);
+            encoded.push_back(std::make_pair(buf, out_len));
+        }
+    }
+    const zmq_frame_vec_t& frames = compress ? encoded : in_frames;
+
+    // new messages are queued behind any spooled messages to preserve the message order
+    if (!spool->empty() && spool->drain(sock, xsink) < 0)
+        return -1;
+    if (spool->empty()) {
+        if (!QoreZSpool::sendFrames(sock, frames))
+            return 0;
+        if (errno != EAGAIN) {
+            zmq_error(xsink, "ZSOCKET-SEND-ERROR", "error in %s()", meth);
+            return -1;
+        }
+    }
+    return spool->append(frames, xsink);
+}
+
+int64 QoreZSock::replayLastValues(const char* prefix, size_t len, ExceptionSink* xsink) {
+    assert(lvc);
+    std::vector<const QoreZLvc::Entry*> matches;
+    lvc->match(prefix, len, matches);
+
+    // cached messages are sent to all subscribers with matching subscriptions, including the new subscriber
+    int64 sent = 0;
+    bool full = false;
+    for (const QoreZLvc::Entry* e : matches) {
+        const char* p = e->data.data();
+        size_t last = e->sizes.size() - 1;
+        for (size_t i = 0; i <= last; ++i) {
+            if (sendFrame(p, e->sizes[i], ZMQ_DONTWAIT | (i == last ? 0 : ZMQ_SNDMORE)) < 0) {
+                // the socket cannot accept more messages; the remaining messages are not replayed
+                if (errno == EAGAIN && !i) {
+                    full = true;
+                    break;
+                }
+                zmq_error(xsink, "ZSOCKET-LVC-ERROR", "error replaying cached messages to a new subscriber");
+                return -1;
+            }
+            p += e->sizes[i];
+        }
+        if (full)
+            break;
+        ++sent;
+    }
+    lvc->addReplay(sent);
+    return sent;
+}
+
+int QoreZSock::waitInput(int timeout_ms) {
+    zmq_pollitem_t p = { sock, 0, ZMQ_POLLIN, 0 };
+    while (true) {
+        int rc = zmq_poll(&p, 1, timeout_ms < 0 ? -1 : timeout_ms);
+        if (rc == -1 && errno == EINTR)
+            continue;
+        return rc;
+    }
+}
+
+QoreListNode* QoreZSock::recvFrameList(int flags, ExceptionSink* xsink, const QoreEncoding* enc) {
+    ReferenceHolder<QoreListNode> rv(new QoreListNode(enc ? stringTypeInfo : binaryTypeInfo), xsink);
+
+    zmq_msg_t msg;
+    zmq_msg_init(&msg);
+    ON_BLOCK_EXIT(zmq_msg_close, &msg);
+
+    while (true) {
+        int rc = zmq_msg_recv(&msg, sock, flags);
+        if (rc < 0) {
+            if (errno == EINTR)
+                continue;
+            return nullptr;
+        }
+
+        // ZeroMQ message buffers cannot be taken over by Qore values, so each frame is copied exactly once into the
+        // buffer of the new value; decoded frames are already in a new buffer, which is taken over
+        size_t size = zmq_msg_size(&msg);
+        if (!rv->size() && !zmq_msg_more(&msg) && checkSubscription(zmq_msg_data(&msg), size, xsink))
+            return nullptr;
+        void* out;
+        size_t out_len;
+        int drc = decodeFrame(zmq_msg_data(&msg), size, out, out_len, xsink);
+        if (drc < 0) {
+            // discard the rest of the message, so that the next receive call does not return its remaining frames
+            // as a new message
+            while (zmq_msg_more(&msg)) {
+                if (zmq_msg_recv(&msg, sock, 0) < 0 && errno != EINTR)
+                    break;
+            }
+            return nullptr;
+        }
+        if (enc) {
+            rv->push(drc
+                ? new QoreStringNode(static_cast<char*>(out), out_len, out_len + 1, enc)
+                : new QoreStringNode(static_cast<const char*>(zmq_msg_data(&msg)), size, enc), nullptr);
+        } else if (drc) {
+            rv->push(new BinaryNode(out, out_len), nullptr);
+        } else {
+            void* p = nullptr;
+            if (size) {
+                p = malloc(size);
+                if (!p) {
+                    xsink->outOfMemory();
+                    return nullptr;
+                }
+                memcpy(p, zmq_msg_data(&msg), size);
+            }
+            rv->push(new BinaryNode(p, size), nullptr);
+        }
+
+        if (!zmq_msg_more(&msg))
+            break;
+        // ZeroMQ delivers multipart messages atomically, so the remaining frames are already available
+        flags = 0;
+    }
+
+    return rv.release();
+}
+
+#ifdef QORE_BUILD_ZMQ_DRAFT
+int QoreZSock::sendSingle(const void* ptr, size_t len, uint32_t routing_id, const char* group) {
+    zmq_msg_t msg;
+    if (zmq_msg_init_size(&msg, len))
+        return -1;
+    if (len)
+        memcpy(zmq_msg_data(&msg), ptr, len);
+
+    if ((routing_id && zmq_msg_set_routing_id(&msg, routing_id)) || (group && zmq_msg_set_group(&msg, group))) {
+        int err = errno;
+        zmq_msg_close(&msg);
+        errno = err;
+        return -1;
+    }
+
+    // thread-safe sockets do not support multipart messages, so the message is always sent as a single part
+    while (true) {
+        int rc = zmq_msg_send(&msg, sock, 0);
+        if (rc < 0) {
+            if (errno == EINTR)
+                continue;
+            int err = errno;
+            zmq_msg_close(&msg);
+            errno = err;
+        }
+        return rc;
+    }
+}
+
+zmsg_t* QoreZSock::recvSingle(int flags, std::string* group) {
+    zmq_msg_t msg;
+    zmq_msg_init(&msg);
+    ON_BLOCK_EXIT(zmq_msg_close, &msg);
+
+    while (true) {
+        int rc = zmq_msg_recv(&msg, sock, flags);
+        if (rc < 0) {
+            if (errno == EINTR)
+                continue;
+            return nullptr;
+        }
+        break;
+    }
+
+    // zmsg_recv() only sets the routing ID for czmq socket objects, so the message is built here
+    zmsg_t* rv = zmsg_new();
+    if (zmsg_addmem(rv, zmq_msg_data(&msg), zmq_msg_size(&msg))) {
+        zmsg_destroy(&rv);
+        errno = ENOMEM;
+        return nullptr;
+    }
+    zmsg_set_routing_id(rv, zmq_msg_routing_id(&msg));
+    if (group) {
+        const char* g = zmq_msg_group(&msg);
+        group->assign(g ? g : "");
+    }
+    return rv;
+}
+#endif
+
+QoreHashNode* QoreZSharedLock::getInfo(ExceptionSink* xsink) const {
+    ReferenceHolder<QoreHashNode> h(new QoreHashNode(hashdeclZmqSharedInfo, xsink), xsink);
+    h->setKeyValue("acquisitions", acquisitions, xsink);
+    h->setKeyValue("contended", contended, xsink);
+    h->setKeyValue("wait_us", wait_us, xsink);
+    h->setKeyValue("max_wait_us", max_wait_us, xsink);
+    return h.release();
+}
+
+int QoreZSock::setShared(ExceptionSink* xsink) {
+    if (check(xsink))
+        return -1;
+    if (shared) {
+        xsink->raiseException("ZSOCKET-SHARED-ERROR", "the socket is already in shared mode");
+        return -1;
+    }
+    if (isThreadSafe()) {
+        xsink->raiseException("ZSOCKET-SHARED-ERROR", "%s sockets are thread-safe and do not need shared mode",
+            getTypeName());
+        return -1;
+    }
+    if (attached) {
+        xsink->raiseException("ZSOCKET-SHARED-ERROR", "the %s socket is used by a ZRpcClient, ZPoller or ZLoop "
+            "object and cannot be put in shared mode", getTypeName());
+        return -1;
+    }
+    // the lock must be in place before other threads are allowed to access the socket
+    shared.reset(new QoreZSharedLock);
+    setThreadSafe();
+    return 0;
+}
+
+int QoreZSock::release(ExceptionSink* xsink) {
+    if (check(xsink))
+        return -1;
+    if (attached) {
+        xsink->raiseException("ZSOCKET-RELEASE-ERROR", "the %s socket is used by a ZRpcClient, ZPoller or ZLoop "
+            "object and cannot be released", getTypeName());
+        return -1;
+    }
+    return AbstractZmqThreadLocalData::release(xsink);
+}
+
 int QoreZSock::poll(short events, int timeout_ms, const char* meth, ExceptionSink *xsink) {
     zmq_pollitem_t p = { sock, 0, events, 0 };
     int rc;
@@ -121,3 +477,94 @@ int QoreZSock::connect(ExceptionSink *xsink, const char* endpoint, const char* e
         zmq_error(xsink, err, "failed to connect to \"%s\"", endpoint);
     return rc;
 }
+
+bool zmq_valid_proxy_command(const char* cmd, size_t len) {
+    return (len == 5 && !memcmp(cmd, "PAUSE", 5))
+        || (len == 6 && !memcmp(cmd, "RESUME", 6))
+        || (len == 9 && !memcmp(cmd, "TERMINATE", 9));
+}
+
+int zmq_claim_native_sockets(QoreZSock* const* socks, size_t n, const char* meth, ExceptionSink* xsink) {
+    for (size_t i = 0; i < n; ++i) {
+        if (!socks[i] || std::find(socks, socks + i, socks[i]) != socks + i)
+            continue;
+        if (socks[i]->claimNativeOwned())
+            continue;
+        // release the sockets claimed so far
+        for (size_t j = 0; j < i; ++j) {
+            if (socks[j] && std::find(socks, socks + j, socks[j]) == socks + j)
+                socks[j]->setNativeOwned(false);
+        }
+        xsink->raiseException("ZSOCKET-THREAD-ERROR", "the %s socket passed to %s() is already used by another "
+            "native proxy or broker thread", socks[i]->getTypeName(), meth);
+        return -1;
+    }
+    return 0;
+}
+
+int zmq_proxy_send_command(void* sock, const char* cmd, const char* meth, ExceptionSink* xsink) {
+    while (true) {
+        int rc = zmq_send(sock, cmd, strlen(cmd), 0);
+        if (rc < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN)
+                zmq_error(xsink, "ZSOCKET-TIMEOUT-ERROR", "timeout in %s()", meth);
+            else
+                zmq_error(xsink, "ZSOCKET-SEND-ERROR", "error in %s()", meth);
+            return -1;
+        }
+        return 0;
+    }
+}
+
+QoreHashNode* zmq_proxy_get_statistics(void* sock, const char* meth, ExceptionSink* xsink) {
+#ifdef QORE_HAVE_ZMQ_PROXY_STATISTICS
+    if (zmq_proxy_send_command(sock, "STATISTICS", meth, xsink))
+        return nullptr;
+
+    // the reply is a message of 8 frames, each holding a uint64_t value in native byte order
+    static const char* keys[] = {
+        "frontend_msgs_in", "frontend_bytes_in", "frontend_msgs_out", "frontend_bytes_out",
+        "backend_msgs_in", "backend_bytes_in", "backend_msgs_out", "backend_bytes_out",
+    };
+    ReferenceHolder<QoreHashNode> h(new QoreHashNode(hashdeclZmqProxyStatistics, xsink), xsink);
+    for (unsigned i = 0; i < 8; ++i) {
+        uint64_t v;
+        int rc;
+        while (true) {
+            rc = zmq_recv(sock, &v, sizeof v, 0);
+            if (rc < 0 && errno == EINTR)
+                continue;
+            break;
+        }
+        if (rc < 0) {
+            if (errno == EAGAIN)
+                zmq_error(xsink, "ZSOCKET-TIMEOUT-ERROR", "timeout in %s()", meth);
+            else
+                zmq_error(xsink, "ZSOCKET-RECVMSG-ERROR", "error in %s()", meth);
+            return nullptr;
+        }
+        if (rc != sizeof v) {
+            xsink->raiseException("ZSOCKET-PROXY-STATISTICS-ERROR", "invalid proxy statistics reply in %s(): frame "
+                "%d/8 has %d bytes; expecting %d", meth, i + 1, rc, (int)sizeof v);
+            return nullptr;
+        }
+        h->setKeyValue(keys[i], (int64)v, xsink);
+
+        int more;
+        size_t len = sizeof more;
+        zmq_getsockopt(sock, ZMQ_RCVMORE, &more, &len);
+        if ((bool)more != (i < 7)) {
+            xsink->raiseException("ZSOCKET-PROXY-STATISTICS-ERROR", "invalid proxy statistics reply in %s(): "
+                "expecting 8 frames; got %s%d", meth, more ? "more than " : "", i + 1);
+            return nullptr;
+        }
+    }
+    return h.release();
+#else
+    xsink->raiseException("ZSOCKET-PROXY-STATISTICS-ERROR", "proxy statistics are not supported by the ZeroMQ library "
+        "version this module was built with; libzmq 4.3 or later is required");
+    return nullptr;
+#endif
+}
@@ -0,0 +1,413 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QoreZSpool.cpp defines the disk-backed overflow spool for sockets */
+/*
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "QoreZSpool.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static void zspool_put32(std::string& buf, uint32_t v) {
+    char b[4] = { (char)(v >> 24), (char)(v >> 16), (char)(v >> 8), (char)v };
+    buf.append(b, 4);
+}
+
+static uint32_t zspool_get32(const unsigned char* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+// returns the current time in milliseconds since the epoch; wall-clock time is used so that the age of messages
+// recovered from an earlier process can be determined
+static int64 zspool_now() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// writes the entire buffer at the given offset; returns 0 or an errno value
+static int zspool_pwrite(int fd, const char* data, size_t len, int64 off) {
+    while (len) {
+        ssize_t rc = ::pwrite(fd, data, len, off);
+        if (rc < 0) {
+            if (errno == EINTR)
+                continue;
+            return errno;
+        }
+        data += rc;
+        len -= rc;
+        off += rc;
+    }
+    return 0;
+}
+
+// reads exactly len bytes at the given offset; returns 0 or an errno value
+static int zspool_pread(int fd, char* data, size_t len, int64 off) {
+    while (len) {
+        ssize_t rc = ::pread(fd, data, len, off);
+        if (rc < 0) {
+            if (errno == EINTR)
+                continue;
+            return errno;
+        }
+        if (!rc)
+            return EIO;
+        data += rc;
+        len -= rc;
+        off += rc;
+    }
+    return 0;
+}
+
+QoreZSpool::QoreZSpool(const char* dir, const QoreHashNode* opts, ExceptionSink* xsink) : dir(dir),
+        prefix(ZSPOOL_DEFAULT_PREFIX), segment_size(ZSPOOL_DEFAULT_SEGMENT_SIZE),
+        max_bytes(ZSPOOL_DEFAULT_MAX_BYTES), max_age(0) {
+    if (opts) {
+        QoreValue v = opts->getKeyValue("prefix");
+        if (!v.isNothing())
+            prefix = v.get<const QoreStringNode>()->c_str();
+        v = opts->getKeyValue("segment_size");
+        if (!v.isNothing())
+            segment_size = v.getAsBigInt();
+        v = opts->getKeyValue("max_bytes");
+        if (!v.isNothing())
+            max_bytes = v.getAsBigInt();
+        v = opts->getKeyValue("max_age");
+        if (!v.isNothing())
+            max_age = v.getAsBigInt();
+    }
+
+    if (prefix.empty() || prefix.find('/') != std::string::npos) {
+        xsink->raiseException("ZSOCKET-SPOOL-ERROR", "invalid segment file prefix '%s'", prefix.c_str());
+        return;
+    }
+    if (segment_size <= ZSPOOL_HEADER_SIZE) {
+        xsink->raiseException("ZSOCKET-SPOOL-ERROR", "invalid segment size " QLLD "; the segment size must be "
+            "greater than %d", segment_size, ZSPOOL_HEADER_SIZE);
+        return;
+    }
+    if (max_bytes < 1) {
+        xsink->raiseException("ZSOCKET-SPOOL-ERROR", "invalid maximum spool size " QLLD "; the value must be "
+            "positive", max_bytes);
+        return;
+    }
+    if (max_age < 0) {
+        xsink->raiseException("ZSOCKET-SPOOL-ERROR", "invalid maximum message age " QLLD "; the value must not be "
+            "negative", max_age);
+        return;
+    }
+
+    // queue messages left by a previous spool in the same directory
+    DIR* d = opendir(dir);
+    if (!d) {
+        xsink->raiseErrnoException("ZSOCKET-SPOOL-ERROR", errno, "cannot read spool directory '%s'", dir);
+        return;
+    }
+    std::vector<int64> nums;
+    {
+        ON_BLOCK_EXIT(closedir, d);
+        size_t plen = prefix.size();
+        size_t slen = strlen(ZSPOOL_SUFFIX);
+        while (struct dirent* de = readdir(d)) {
+            const char* name = de->d_name;
+            size_t len = strlen(name);
+            if (len <= plen + 1 + slen || strncmp(name, prefix.c_str(), plen) || name[plen] != '-'
+                || strcmp(name + len - slen, ZSPOOL_SUFFIX)) {
+                continue;
+            }
+            std::string num(name + plen + 1, len - plen - 1 - slen);
+            if (num.find_first_not_of("0123456789") != std::string::npos)
+                continue;
+            nums.push_back(strtoll(num.c_str(), nullptr, 10));
+        }
+    }
+    std::sort(nums.begin(), nums.end());
+    for (int64 n : nums) {
+        if (recover(n, xsink))
+            return;
+    }
+    if (!nums.empty())
+        seq = nums.back();
+}
+
+QoreZSpool::~QoreZSpool() {
+    for (auto& i : segs) {
+        ::close(i.fd);
+    }
+}
+
+std::string QoreZSpool::getSegmentPath(int64 n) const {
+    QoreStringMaker str("%s/%s-%010lld%s", dir.c_str(), prefix.c_str(), n, ZSPOOL_SUFFIX);
+    return str.c_str();
+}
+
+int QoreZSpool::recover(int64 n, ExceptionSink* xsink) {
+    std::string path = getSegmentPath(n);
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        xsink->raiseErrnoException("ZSOCKET-SPOOL-ERROR", errno, "cannot open spool segment '%s'", path.c_str());
+        return -1;
+    }
+    struct stat sbuf;
+    if (fstat(fd, &sbuf)) {
+        xsink->raiseErrnoException("ZSOCKET-SPOOL-ERROR", errno, "cannot stat spool segment '%s'", path.c_str());
+        ::close(fd);
+        return -1;
+    }
+
+    unsigned char hdr[ZSPOOL_HEADER_SIZE];
+    if (sbuf.st_size < ZSPOOL_HEADER_SIZE || zspool_pread(fd, (char*)hdr, ZSPOOL_HEADER_SIZE, 0)
+        || memcmp(hdr, ZSPOOL_MAGIC, 4) || zspool_get32(hdr + 4) != ZSPOOL_VERSION) {
+        xsink->raiseException("ZSOCKET-SPOOL-ERROR", "'%s' is not a valid spool segment", path.c_str());
+        ::close(fd);
+        return -1;
+    }
+
+    // count the complete records; an incomplete final record, as left by a crash while writing, is ignored
+    int64 pos = ZSPOOL_HEADER_SIZE;
+    while (sbuf.st_size - pos >= 4) {
+        unsigned char lbuf[4];
+        int err = zspool_pread(fd, (char*)lbuf, 4, pos);
+        if (err) {
+            xsink->raiseErrnoException("ZSOCKET-SPOOL-ERROR", err, "cannot read spool segment '%s'", path.c_str());
+            ::close(fd);
+            return -1;
+        }
+        int64 len = zspool_get32(lbuf);
+        if (len < ZSPOOL_RECORD_HEADER_SIZE - 4 || sbuf.st_size - pos - 4 < len)
+            break;
+        pos += 4 + len;
+        bytes += 4 + len;
+        ++messages;
+    }
+
+    segs.push_back({n, fd, pos, ZSPOOL_HEADER_SIZE, false});
+    return 0;
+}
+
+int QoreZSpool::newSegment(ExceptionSink* xsink) {
+    std::string path = getSegmentPath(++seq);
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        xsink->raiseErrnoException("ZSOCKET-SPOOL-ERROR", errno, "cannot create spool segment '%s'", path.c_str());
+        return -1;
+    }
+
+    std::string hdr(ZSPOOL_MAGIC, 4);
+    zspool_put32(hdr, ZSPOOL_VERSION);
+    zspool_put32(hdr, (uint32_t)((uint64_t)seq >> 32));
+    zspool_put32(hdr, (uint32_t)seq);
+    int err = zspool_pwrite(fd, hdr.data(), hdr.size(), 0);
+    if (err) {
+        xsink->raiseErrnoException("ZSOCKET-SPOOL-ERROR", err, "cannot write to spool segment '%s'",
+            path.c_str());
+        ::close(fd);
+        unlink(path.c_str());
+        return -1;
+    }
+
+    segs.push_back({seq, fd, ZSPOOL_HEADER_SIZE, ZSPOOL_HEADER_SIZE, true});
+    return 0;
+}
+
+void QoreZSpool::removeSegment() {
+    Segment& s = segs.front();
+    ::close(s.fd);
+    unlink(getSegmentPath(s.seq).c_str());
+    segs.pop_front();
+}
+
+int QoreZSpool::append(const zmq_frame_vec_t& frames, ExceptionSink* xsink) {
+    assert(!frames.empty());
+
+    size_t rec_size = ZSPOOL_RECORD_HEADER_SIZE;
+    for (auto& i : frames) {
+        rec_size += 4 + i.second;
+    }
+    if (rec_size - 4 > 0xffffffffull) {
+        xsink->raiseException("ZSOCKET-SPOOL-ERROR", "cannot spool a message of %lld bytes; the maximum record "
+            "size is 4GB", (int64)rec_size);
+        return -1;
+    }
+    if (bytes + (int64)rec_size > max_bytes) {
+        xsink->raiseException("ZSOCKET-SPOOL-FULL", "cannot spool a message of %lld bytes; the spool already holds "
+            QLLD " bytes in " QLLD " message%s and the limit is " QLLD " bytes", (int64)rec_size, bytes, messages,
+            messages == 1 ? "" : "s", max_bytes);
+        return -1;
+    }
+
+    // a record larger than the segment size is written to its own segment
+    if (segs.empty() || !segs.back().writable
+        || (segs.back().size > ZSPOOL_HEADER_SIZE && segs.back().size + (int64)rec_size > segment_size)) {
+        if (!segs.empty())
+            segs.back().writable = false;
+        if (newSegment(xsink))
+            return -1;
+    }
+
+    std::string buf;
+    buf.reserve(rec_size);
+    zspool_put32(buf, (uint32_t)(rec_size - 4));
+    int64 now = zspool_now();
+    zspool_put32(buf, (uint32_t)((uint64_t)now >> 32));
+    zspool_put32(buf, (uint32_t)now);
+    zspool_put32(buf, (uint32_t)frames.size());
+    for (auto& i : frames) {
+        zspool_put32(buf, (uint32_t)i.second);
+        buf.append(i.first, i.second);
+    }
+
+    Segment& s = segs.back();
+    int err = zspool_pwrite(s.fd, buf.data(), buf.size(), s.size);
+    if (err) {
+        xsink->raiseErrnoException("ZSOCKET-SPOOL-ERROR", err, "cannot write to spool segment '%s'",
+            getSegmentPath(s.seq).c_str());
+        return -1;
+    }
+    s.size += rec_size;
+    bytes += rec_size;
+    ++messages;
+    ++spooled;
+    return 0;
+}
+
+int QoreZSpool::readRecord(ExceptionSink* xsink) {
+    while (!segs.empty()) {
+        Segment& s = segs.front();
+        if (s.pos < s.size) {
+            unsigned char lbuf[4];
+            int err = zspool_pread(s.fd, (char*)lbuf, 4, s.pos);
+            if (!err) {
+                size_t len = zspool_get32(lbuf);
+                rec.resize(4 + len);
+                memcpy(&rec[0], lbuf, 4);
+                err = zspool_pread(s.fd, &rec[4], len, s.pos + 4);
+            }
+            if (err) {
+                xsink->raiseErrnoException("ZSOCKET-SPOOL-ERROR", err, "cannot read spool segment '%s'",
+                    getSegmentPath(s.seq).c_str());
+                return -1;
+            }
+            s.pos += rec.size();
+            have_rec = true;
+            return 1;
+        }
+        // the segment has been sent completely
+        removeSegment();
+    }
+    return 0;
+}
+
+int QoreZSpool::sendFrames(void* sock, const zmq_frame_vec_t& frames) {
+    size_t size = frames.size();
+    for (size_t i = 0; i < size; ++i) {
+        // ZeroMQ only applies the high water mark to the first frame of a message, and the remaining frames of a
+        // multipart message are always accepted once the first frame has been queued
+        int flags = (i ? 0 : ZMQ_DONTWAIT) | (i == size - 1 ? 0 : ZMQ_SNDMORE);
+        while (true) {
+            int rc = zmq_send(sock, frames[i].first, frames[i].second, flags);
+            if (rc < 0) {
+                if (errno == EINTR)
+                    continue;
+                return -1;
+            }
+            break;
+        }
+    }
+    return 0;
+}
+
+int64 QoreZSpool::drain(void* sock, ExceptionSink* xsink) {
+    int64 sent = 0;
+    zmq_frame_vec_t frames;
+    while (true) {
+        if (!have_rec) {
+            int rc = readRecord(xsink);
+            if (rc < 0)
+                return -1;
+            if (!rc)
+                break;
+        }
+
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(rec.data());
+        size_t rec_size = rec.size();
+        int64 ts = ((int64)zspool_get32(p + 4) << 32) | zspool_get32(p + 8);
+        if (max_age && zspool_now() - ts > max_age) {
+            // the message is discarded
+            have_rec = false;
+            bytes -= rec_size;
+            --messages;
+            ++expired;
+            continue;
+        }
+
+        // parse and validate the frames
+        frames.clear();
+        size_t count = zspool_get32(p + 12);
+        size_t off = ZSPOOL_RECORD_HEADER_SIZE;
+        for (size_t i = 0; i < count; ++i) {
+            if (rec_size - off < 4)
+                break;
+            size_t len = zspool_get32(p + off);
+            off += 4;
+            if (rec_size - off < len)
+                break;
+            frames.push_back(std::make_pair((const char*)p + off, len));
+            off += len;
+        }
+        if (!count || frames.size() != count || off != rec_size) {
+            xsink->raiseException("ZSOCKET-SPOOL-ERROR", "invalid record in spool segment '%s'",
+                getSegmentPath(segs.front().seq).c_str());
+            return -1;
+        }
+
+        if (sendFrames(sock, frames)) {
+            if (errno == EAGAIN)
+                break;
+            zmq_error(xsink, "ZSOCKET-SEND-ERROR", "error sending spooled message");
+            return -1;
+        }
+
+        have_rec = false;
+        bytes -= rec_size;
+        --messages;
+        ++drained;
+        ++sent;
+    }
+
+    return sent;
+}
+
+QoreHashNode* QoreZSpool::getInfo(ExceptionSink* xsink) const {
+    ReferenceHolder<QoreHashNode> h(new QoreHashNode(hashdeclZmqSpoolInfo, xsink), xsink);
+    h->setKeyValue("messages", messages, xsink);
+    h->setKeyValue("bytes", bytes, xsink);
+    h->setKeyValue("segments", (int64)segs.size(), xsink);
+    h->setKeyValue("spooled", spooled, xsink);
+    h->setKeyValue("drained", drained, xsink);
+    h->setKeyValue("expired", expired, xsink);
+    return h.release();
+}
@@ -0,0 +1,139 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QoreZSpool.h defines the disk-backed overflow spool for sockets */
+/*
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_ZMQ_QOREZSPOOL_H
+
+#define _QORE_ZMQ_QOREZSPOOL_H
+
+#include "zmq-module.h"
+
+#include <czmq.h>
+
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+// the spool segment file magic value
+#define ZSPOOL_MAGIC "QZS\x01"
+// the spool segment file format version
+#define ZSPOOL_VERSION 1
+// the size of the segment file header: magic, version and segment number
+#define ZSPOOL_HEADER_SIZE 16
+// the size of the fixed part of a record: length, timestamp and frame count
+#define ZSPOOL_RECORD_HEADER_SIZE 16
+// the file name suffix for spool segments
+#define ZSPOOL_SUFFIX ".zs"
+
+// default option values
+#define ZSPOOL_DEFAULT_PREFIX "spool"
+#define ZSPOOL_DEFAULT_SEGMENT_SIZE (16ll * 1024 * 1024)
+#define ZSPOOL_DEFAULT_MAX_BYTES (1024ll * 1024 * 1024)
+
+// the frames of a message to send: a pointer to the data and the length of each frame
+typedef std::vector<std::pair<const char*, size_t>> zmq_frame_vec_t;
+
+// queues messages that cannot be sent immediately in segment files and sends them in order once the socket accepts
+// messages again; not thread-safe, the spool is only used by the thread that owns the socket
+class QoreZSpool {
+public:
+    // opens the spool; any messages left in existing segments in the directory are queued before new messages
+    DLLLOCAL QoreZSpool(const char* dir, const QoreHashNode* opts, ExceptionSink* xsink);
+
+    // closes all segment files; undelivered messages remain on disk
+    DLLLOCAL ~QoreZSpool();
+
+    DLLLOCAL bool empty() const {
+        return !messages;
+    }
+
+    DLLLOCAL int64 getMessages() const {
+        return messages;
+    }
+
+    // queues a message; returns -1 for error (exception raised)
+    DLLLOCAL int append(const zmq_frame_vec_t& frames, ExceptionSink* xsink);
+
+    // sends queued messages in order until the socket would block or the spool is empty; returns the number of
+    // messages sent or -1 for error (exception raised)
+    DLLLOCAL int64 drain(void* sock, ExceptionSink* xsink);
+
+    // returns a ZmqSpoolInfo hash
+    DLLLOCAL QoreHashNode* getInfo(ExceptionSink* xsink) const;
+
+    // sends a message without blocking; returns -1 for error (errno set), 0 for OK
+    DLLLOCAL static int sendFrames(void* sock, const zmq_frame_vec_t& frames);
+
+private:
+    struct Segment {
+        int64 seq;
+        int fd;
+        // the end of the last complete record
+        int64 size;
+        // the offset of the next record to send
+        int64 pos;
+        // true if messages can be appended to the segment
+        bool writable;
+    };
+
+    std::string dir;
+    std::string prefix;
+    int64 segment_size;
+    int64 max_bytes;
+    // the maximum age of a queued message in milliseconds; 0 = no limit
+    int64 max_age;
+
+    // segments in order; messages are sent from the first and appended to the last
+    std::deque<Segment> segs;
+    // the number of the last segment created
+    int64 seq = 0;
+
+    // the record at the head of the queue, read but not yet sent
+    std::string rec;
+    bool have_rec = false;
+
+    // the number of messages and bytes queued
+    int64 messages = 0;
+    int64 bytes = 0;
+    // totals since the spool was opened
+    int64 spooled = 0;
+    int64 drained = 0;
+    int64 expired = 0;
+
+    // scans and queues an existing segment; returns -1 for error (exception raised)
+    DLLLOCAL int recover(int64 n, ExceptionSink* xsink);
+
+    // creates a new segment for appending; returns -1 for error (exception raised)
+    DLLLOCAL int newSegment(ExceptionSink* xsink);
+
+    // reads the next record into the record buffer, removing exhausted segments; returns 1 if a record was read, 0
+    // if the spool is empty and -1 for error (exception raised)
+    DLLLOCAL int readRecord(ExceptionSink* xsink);
+
+    // closes and deletes the first segment
+    DLLLOCAL void removeSegment();
+
+    // returns the path of the given segment
+    DLLLOCAL std::string getSegmentPath(int64 n) const;
+};
+
+#endif // _QORE_ZMQ_QOREZSPOOL_H
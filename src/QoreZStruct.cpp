@@ -0,0 +1,466 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QoreZStruct.cpp defines the codec for arrays of fixed-layout binary records */
+/*
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "QoreZStruct.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+static bool zstruct_host_is_big_endian() {
+    const uint16_t i = 1;
+    return !*reinterpret_cast<const unsigned char*>(&i);
+}
+
+// reads a value of the given type; with native byte order this is a single unaligned load
+template <typename T>
+static T zstruct_get(const unsigned char* p, bool swap) {
+    T v;
+    if (!swap) {
+        memcpy(&v, p, sizeof(T));
+        return v;
+    }
+    unsigned char b[sizeof(T)];
+    for (size_t i = 0; i < sizeof(T); ++i)
+        b[i] = p[sizeof(T) - 1 - i];
+    memcpy(&v, b, sizeof(T));
+    return v;
+}
+
+// writes a value of the given type; with native byte order this is a single unaligned store
+template <typename T>
+static void zstruct_put(unsigned char* p, T v, bool swap) {
+    if (!swap) {
+        memcpy(p, &v, sizeof(T));
+        return;
+    }
+    unsigned char b[sizeof(T)];
+    memcpy(b, &v, sizeof(T));
+    for (size_t i = 0; i < sizeof(T); ++i)
+        p[i] = b[sizeof(T) - 1 - i];
+}
+
+int QoreZStruct::parse(const QoreString* fmt, ExceptionSink* xsink) {
+    const char* p = fmt->c_str();
+    const char* end = p + fmt->size();
+
+    bool host_big = zstruct_host_is_big_endian();
+    bool big_endian = host_big;
+    switch (*p) {
+        case '<': big_endian = false; ++p; break;
+        case '>':
+        case '!': big_endian = true; ++p; break;
+        case '=': ++p; break;
+    }
+    swap = big_endian != host_big;
+
+    while (true) {
+        while (p < end && (isspace(*p) || *p == ','))
+            ++p;
+        if (p == end)
+            break;
+
+        // get the next field specification
+        const char* start = p;
+        while (p < end && !isspace(*p) && *p != ',')
+            ++p;
+        std::string spec(start, p - start);
+
+        std::string name;
+        size_t colon = spec.find(':');
+        const char* t = spec.c_str();
+        if (colon != std::string::npos) {
+            name.assign(spec, 0, colon);
+            t += colon + 1;
+        }
+
+        size_t count = 0;
+        bool have_count = false;
+        while (isdigit(*t)) {
+            count = count * 10 + (*t - '0');
+            if (count > 0x7fffffff) {
+                xsink->raiseException(err, "field size in format specification '%s' is too large", spec.c_str());
+                return -1;
+            }
+            have_count = true;
+            ++t;
+        }
+        char type = *t;
+        if (!type || t[1]) {
+            xsink->raiseException(err, "invalid format specification '%s'; expecting [name:][count]type",
+                spec.c_str());
+            return -1;
+        }
+        if (have_count && !count) {
+            xsink->raiseException(err, "invalid zero size in format specification '%s'", spec.c_str());
+            return -1;
+        }
+
+        size_t size;
+        switch (type) {
+            case 'x':
+                // padding is skipped when unpacking and written as zero bytes when packing
+                if (!name.empty()) {
+                    xsink->raiseException(err, "padding specification '%s' must not have a field name",
+                        spec.c_str());
+                    return -1;
+                }
+                rec_size += have_count ? count : 1;
+                continue;
+            case 's':
+                size = have_count ? count : 1;
+                break;
+            case '?':
+            case 'b':
+            case 'B':
+                size = 1;
+                break;
+            case 'h':
+            case 'H':
+                size = 2;
+                break;
+            case 'i':
+            case 'I':
+            case 'f':
+                size = 4;
+                break;
+            case 'q':
+            case 'Q':
+            case 'd':
+                size = 8;
+                break;
+            default:
+                xsink->raiseException(err, "unknown type code '%c' in format specification '%s'", type,
+                    spec.c_str());
+                return -1;
+        }
+        if (have_count && type != 's') {
+            xsink->raiseException(err, "a size can only be given for 's' and 'x' fields; format specification: '%s'",
+                spec.c_str());
+            return -1;
+        }
+        if (name.empty()) {
+            xsink->raiseException(err, "format specification '%s' is missing a field name", spec.c_str());
+            return -1;
+        }
+        for (const Field& f : fields) {
+            if (f.name == name) {
+                xsink->raiseException(err, "duplicate field name '%s' in format", name.c_str());
+                return -1;
+            }
+        }
+
+        fields.push_back({name, type, size, rec_size});
+        rec_size += size;
+    }
+
+    if (fields.empty()) {
+        xsink->raiseException(err, "the format '%s' does not define any fields", fmt->c_str());
+        return -1;
+    }
+    return 0;
+}
+
+int64 QoreZStruct::getCount(size_t len, int64 offset, int64 count, ExceptionSink* xsink) const {
+    if (offset < 0 || (size_t)offset > len) {
+        xsink->raiseException(err, "invalid offset " QLLD "; data size: %lld", offset, (int64)len);
+        return -1;
+    }
+    size_t avail = len - offset;
+    if (count < 0) {
+        if (avail % rec_size) {
+            xsink->raiseException(err, "%lld bytes of record data is not a multiple of the record size %lld",
+                (int64)avail, (int64)rec_size);
+            return -1;
+        }
+        return avail / rec_size;
+    }
+    if ((size_t)count > avail / rec_size) {
+        xsink->raiseException(err, "cannot unpack " QLLD " records of %lld bytes; only %lld bytes are available",
+            count, (int64)rec_size, (int64)avail);
+        return -1;
+    }
+    return count;
+}
+
+QoreValue QoreZStruct::getValue(const Field& f, const unsigned char* rec, ExceptionSink* xsink) const {
+    const unsigned char* p = rec + f.offset;
+    switch (f.type) {
+        case '?': return (bool)*p;
+        case 'b': return (int64)(int8_t)*p;
+        case 'B': return (int64)*p;
+        case 'h': return (int64)zstruct_get<int16_t>(p, swap);
+        case 'H': return (int64)zstruct_get<uint16_t>(p, swap);
+        case 'i': return (int64)zstruct_get<int32_t>(p, swap);
+        case 'I': return (int64)zstruct_get<uint32_t>(p, swap);
+        case 'q': return (int64)zstruct_get<int64_t>(p, swap);
+        case 'Q': {
+            uint64_t v = zstruct_get<uint64_t>(p, swap);
+            if (v > 0x7fffffffffffffffull) {
+                xsink->raiseException(err, "unsigned value %llu of field '%s' cannot be represented as an integer",
+                    (unsigned long long)v, f.name.c_str());
+                return QoreValue();
+            }
+            return (int64)v;
+        }
+        case 'f': return (double)zstruct_get<float>(p, swap);
+        case 'd': return zstruct_get<double>(p, swap);
+        case 's': {
+            // fixed-width strings are padded with null bytes
+            const char* s = reinterpret_cast<const char*>(p);
+            return new QoreStringNode(s, strnlen(s, f.size), QCS_DEFAULT);
+        }
+    }
+    assert(false);
+    return QoreValue();
+}
+
+int QoreZStruct::setValue(const Field& f, unsigned char* rec, const QoreValue& v, int64 i,
+        ExceptionSink* xsink) const {
+    if (v.isNothing()) {
+        xsink->raiseException(err, "record " QLLD " has no value for field '%s'", i, f.name.c_str());
+        return -1;
+    }
+
+    // numeric fields are never packed from non-numeric values, which would otherwise be silently converted
+    if (f.type != '?' && f.type != 's') {
+        qore_type_t t = v.getType();
+        if (t != NT_INT && t != NT_FLOAT && t != NT_NUMBER) {
+            xsink->raiseException(err, "record " QLLD " field '%s': expecting a numeric value for type '%c'; got "
+                "type '%s' instead", i, f.name.c_str(), f.type, v.getTypeName());
+            return -1;
+        }
+    }
+
+    unsigned char* p = rec + f.offset;
+    switch (f.type) {
+        case '?':
+            *p = v.getAsBool() ? 1 : 0;
+            return 0;
+        case 'f':
+            zstruct_put<float>(p, (float)v.getAsFloat(), swap);
+            return 0;
+        case 'd':
+            zstruct_put<double>(p, v.getAsFloat(), swap);
+            return 0;
+        case 's': {
+            QoreStringValueHelper str(v);
+            if (str->size() > f.size) {
+                xsink->raiseException(err, "record " QLLD " field '%s': string of %lld bytes does not fit in %lld "
+                    "bytes", i, f.name.c_str(), (int64)str->size(), (int64)f.size);
+                return -1;
+            }
+            // the remainder of the field has already been zeroed
+            memcpy(p, str->c_str(), str->size());
+            return 0;
+        }
+    }
+
+    // integer fields
+    int64 n;
+    if (v.getType() == NT_INT) {
+        n = v.getAsBigInt();
+    } else {
+        // floating-point and arbitrary-precision values must be integral and representable as a 64-bit integer
+        double d = v.getAsFloat();
+        if (d != floor(d) || d < -9223372036854775808.0 || d >= 9223372036854775808.0) {
+            xsink->raiseException(err, "record " QLLD " field '%s': value %g is not an integer or is out of range "
+                "for type '%c'", i, f.name.c_str(), d, f.type);
+            return -1;
+        }
+        n = (int64)d;
+    }
+    int64 min, max;
+    switch (f.type) {
+        case 'b': min = INT8_MIN; max = INT8_MAX; break;
+        case 'B': min = 0; max = UINT8_MAX; break;
+        case 'h': min = INT16_MIN; max = INT16_MAX; break;
+        case 'H': min = 0; max = UINT16_MAX; break;
+        case 'i': min = INT32_MIN; max = INT32_MAX; break;
+        case 'I': min = 0; max = UINT32_MAX; break;
+        case 'Q': min = 0; max = INT64_MAX; break;
+        default: min = INT64_MIN; max = INT64_MAX; break;
+    }
+    if (n < min || n > max) {
+        xsink->raiseException(err, "record " QLLD " field '%s': value " QLLD " is out of range for type '%c'", i,
+            f.name.c_str(), n, f.type);
+        return -1;
+    }
+
+    switch (f.type) {
+        case 'b':
+        case 'B':
+            *p = (unsigned char)n;
+            break;
+        case 'h':
+        case 'H':
+            zstruct_put<uint16_t>(p, (uint16_t)n, swap);
+            break;
+        case 'i':
+        case 'I':
+            zstruct_put<uint32_t>(p, (uint32_t)n, swap);
+            break;
+        default:
+            zstruct_put<uint64_t>(p, (uint64_t)n, swap);
+            break;
+    }
+    return 0;
+}
+
+QoreListNode* QoreZStruct::unpack(const void* data, size_t len, int64 offset, int64 count,
+        ExceptionSink* xsink) const {
+    count = getCount(len, offset, count, xsink);
+    if (count < 0)
+        return nullptr;
+
+    ReferenceHolder<QoreListNode> rv(new QoreListNode(autoHashTypeInfo), xsink);
+    const unsigned char* rec = static_cast<const unsigned char*>(data) + offset;
+    for (int64 i = 0; i < count; ++i, rec += rec_size) {
+        ReferenceHolder<QoreHashNode> h(new QoreHashNode(autoTypeInfo), xsink);
+        for (const Field& f : fields) {
+            ValueHolder v(getValue(f, rec, xsink), xsink);
+            if (*xsink)
+                return nullptr;
+            h->setKeyValue(f.name.c_str(), v.release(), xsink);
+        }
+        rv->push(h.release(), xsink);
+    }
+    return rv.release();
+}
+
+QoreHashNode* QoreZStruct::unpackColumns(const void* data, size_t len, int64 offset, int64 count,
+        ExceptionSink* xsink) const {
+    count = getCount(len, offset, count, xsink);
+    if (count < 0)
+        return nullptr;
+
+    ReferenceHolder<QoreHashNode> rv(new QoreHashNode(autoTypeInfo), xsink);
+    // the lists are owned by the hash
+    std::vector<QoreListNode*> cols;
+    cols.reserve(fields.size());
+    for (const Field& f : fields) {
+        QoreListNode* l = new QoreListNode(autoTypeInfo);
+        rv->setKeyValue(f.name.c_str(), l, xsink);
+        cols.push_back(l);
+    }
+
+    // fill each column in turn so that each inner loop reads one field at a fixed stride
+    const unsigned char* begin = static_cast<const unsigned char*>(data) + offset;
+    for (size_t c = 0; c < fields.size(); ++c) {
+        const Field& f = fields[c];
+        QoreListNode* l = cols[c];
+        const unsigned char* rec = begin;
+        for (int64 i = 0; i < count; ++i, rec += rec_size) {
+            ValueHolder v(getValue(f, rec, xsink), xsink);
+            if (*xsink)
+                return nullptr;
+            l->push(v.release(), xsink);
+        }
+    }
+    return rv.release();
+}
+
+zframe_t* QoreZStruct::newFrame(size_t count, ExceptionSink* xsink) const {
+    if (count && rec_size > SIZE_MAX / count) {
+        xsink->raiseException(err, "cannot pack %lld records of %lld bytes", (int64)count, (int64)rec_size);
+        return nullptr;
+    }
+    size_t size = count * rec_size;
+    // allocate the frame without initializing its data and write the records directly into it
+    zframe_t* frame = zframe_new(nullptr, size);
+    if (!frame) {
+        xsink->outOfMemory();
+        return nullptr;
+    }
+    // padding and unused string bytes are written as zeros
+    if (size)
+        memset(zframe_data(frame), 0, size);
+    return frame;
+}
+
+zframe_t* QoreZStruct::pack(const QoreListNode* records, ExceptionSink* xsink) const {
+    zframe_t* frame = newFrame(records->size(), xsink);
+    if (!frame)
+        return nullptr;
+
+    unsigned char* rec = zframe_data(frame);
+    ConstListIterator li(records);
+    while (li.next()) {
+        const QoreValue v = li.getValue();
+        if (v.getType() != NT_HASH) {
+            zframe_destroy(&frame);
+            xsink->raiseException(err, "record %lld has type '%s'; expecting 'hash'", (int64)li.index(),
+                v.getTypeName());
+            return nullptr;
+        }
+        const QoreHashNode* h = v.get<const QoreHashNode>();
+        for (const Field& f : fields) {
+            if (setValue(f, rec, h->getKeyValue(f.name.c_str()), li.index(), xsink)) {
+                zframe_destroy(&frame);
+                return nullptr;
+            }
+        }
+        rec += rec_size;
+    }
+    return frame;
+}
+
+zframe_t* QoreZStruct::pack(const QoreHashNode* columns, ExceptionSink* xsink) const {
+    std::vector<const QoreListNode*> cols;
+    cols.reserve(fields.size());
+    for (const Field& f : fields) {
+        QoreValue v = columns->getKeyValue(f.name.c_str());
+        if (v.getType() != NT_LIST) {
+            xsink->raiseException(err, "column '%s' has type '%s'; expecting 'list'", f.name.c_str(),
+                v.getTypeName());
+            return nullptr;
+        }
+        const QoreListNode* l = v.get<const QoreListNode>();
+        if (!cols.empty() && l->size() != cols[0]->size()) {
+            xsink->raiseException(err, "column '%s' has %lld values, but column '%s' has %lld values",
+                f.name.c_str(), (int64)l->size(), fields[0].name.c_str(), (int64)cols[0]->size());
+            return nullptr;
+        }
+        cols.push_back(l);
+    }
+
+    size_t count = cols[0]->size();
+    zframe_t* frame = newFrame(count, xsink);
+    if (!frame)
+        return nullptr;
+
+    unsigned char* begin = zframe_data(frame);
+    for (size_t c = 0; c < fields.size(); ++c) {
+        const Field& f = fields[c];
+        unsigned char* rec = begin;
+        ConstListIterator li(cols[c]);
+        while (li.next()) {
+            if (setValue(f, rec, li.getValue(), li.index(), xsink)) {
+                zframe_destroy(&frame);
+                return nullptr;
+            }
+            rec += rec_size;
+        }
+    }
+    return frame;
+}
@@ -0,0 +1,99 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/** @file QoreZStruct.h defines the codec for arrays of fixed-layout binary records */
+/*
+    Qore Programming Language
+
+    Copyright (C) 2026 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_ZMQ_QOREZSTRUCT_H
+
+#define _QORE_ZMQ_QOREZSTRUCT_H
+
+#include "zmq-module.h"
+
+#include <czmq.h>
+
+#include <string>
+#include <vector>
+
+// packs and unpacks arrays of records with a fixed binary layout described by a format string; the format is
+// compiled once in parse() and then applied to all records in a single pass
+class QoreZStruct {
+public:
+    DLLLOCAL QoreZStruct(const char* err) : err(err) {
+    }
+
+    // parses the format string; returns -1 for error (exception raised)
+    DLLLOCAL int parse(const QoreString* fmt, ExceptionSink* xsink);
+
+    // returns the size of a single record in bytes
+    DLLLOCAL size_t getRecordSize() const {
+        return rec_size;
+    }
+
+    // unpacks records to a list of hashes; count = -1 means all records in the buffer; returns nullptr for error
+    // (exception raised)
+    DLLLOCAL QoreListNode* unpack(const void* data, size_t len, int64 offset, int64 count,
+            ExceptionSink* xsink) const;
+
+    // unpacks records to a hash of lists keyed by field name; count = -1 means all records in the buffer; returns
+    // nullptr for error (exception raised)
+    DLLLOCAL QoreHashNode* unpackColumns(const void* data, size_t len, int64 offset, int64 count,
+            ExceptionSink* xsink) const;
+
+    // packs a list of hashes into a new frame; returns nullptr for error (exception raised)
+    DLLLOCAL zframe_t* pack(const QoreListNode* records, ExceptionSink* xsink) const;
+
+    // packs a hash of lists keyed by field name into a new frame; returns nullptr for error (exception raised)
+    DLLLOCAL zframe_t* pack(const QoreHashNode* columns, ExceptionSink* xsink) const;
+
+private:
+    struct Field {
+        // the hash key for the field
+        std::string name;
+        // the type code from the format string
+        char type;
+        // the size of the field in bytes
+        size_t size;
+        // the offset of the field in the record
+        size_t offset;
+    };
+
+    // the exception code for errors
+    const char* err;
+    // fields in record order; padding is not stored
+    std::vector<Field> fields;
+    size_t rec_size = 0;
+    // true if the byte order of the records differs from the host byte order
+    bool swap = false;
+
+    // checks the buffer and returns the number of records to unpack or -1 for error (exception raised)
+    DLLLOCAL int64 getCount(size_t len, int64 offset, int64 count, ExceptionSink* xsink) const;
+
+    // returns the value of the given field in the given record
+    DLLLOCAL QoreValue getValue(const Field& f, const unsigned char* rec, ExceptionSink* xsink) const;
+
+    // writes a value to the given field in the given record; returns -1 for error (exception raised)
+    DLLLOCAL int setValue(const Field& f, unsigned char* rec, const QoreValue& v, int64 i,
+            ExceptionSink* xsink) const;
+
+    // returns a new frame for the given number of records or nullptr for error (exception raised)
+    DLLLOCAL zframe_t* newFrame(size_t count, ExceptionSink* xsink) const;
+};
+
+#endif // _QORE_ZMQ_QOREZSTRUCT_H
@@ -32,10 +32,56 @@ DLLLOCAL void preinitZMsgClass();
 // for hashdecls
 const TypedHashDecl* hashdeclZmqVersionInfo,
     * hashdeclZmqPollInfo,
-    * hashdeclZmqCurveKeyInfo;
+    * hashdeclZmqCurveKeyInfo,
+    * hashdeclZmqProxyStatistics,
+    * hashdeclZmqMonitorEvent,
+    * hashdeclZmqContextOptions,
+    * hashdeclZmqJournalOptions,
+    * hashdeclZmqSpoolOptions,
+    * hashdeclZmqSpoolInfo,
+    * hashdeclZmqCompressionInfo,
+    * hashdeclZmqLvcOptions,
+    * hashdeclZmqLvcInfo,
+    * hashdeclZmqConflationOptions,
+    * hashdeclZmqConflationInfo,
+    * hashdeclZmqBrokerOptions,
+    * hashdeclZmqBrokerStatistics,
+    * hashdeclZmqRpcOptions,
+    * hashdeclZmqRpcResult,
+    * hashdeclZmqRpcInfo,
+    * hashdeclZmqFramerOptions,
+    * hashdeclZmqFramerInfo,
+    * hashdeclZmqStreamMessage,
+    * hashdeclZmqSharedInfo;
+#ifdef QORE_BUILD_ZMQ_DRAFT
+const TypedHashDecl* hashdeclZmqGroupMessage;
+#endif
 DLLLOCAL TypedHashDecl* init_hashdecl_ZmqVersionInfo(QoreNamespace& ns);
 DLLLOCAL TypedHashDecl* init_hashdecl_ZmqPollInfo(QoreNamespace& ns);
 DLLLOCAL TypedHashDecl* init_hashdecl_ZmqCurveKeyInfo(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqProxyStatistics(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqMonitorEvent(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqContextOptions(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqJournalOptions(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqSpoolOptions(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqSpoolInfo(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqCompressionInfo(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqLvcOptions(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqLvcInfo(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqConflationOptions(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqConflationInfo(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqBrokerOptions(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqBrokerStatistics(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqRpcOptions(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqRpcResult(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqRpcInfo(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqFramerOptions(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqFramerInfo(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqStreamMessage(QoreNamespace& ns);
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqSharedInfo(QoreNamespace& ns);
+#ifdef QORE_BUILD_ZMQ_DRAFT
+DLLLOCAL TypedHashDecl* init_hashdecl_ZmqGroupMessage(QoreNamespace& ns);
+#endif
 
 DLLLOCAL QoreClass* initZContextClass(QoreNamespace& ns);
 DLLLOCAL QoreClass* initZSocketClass(QoreNamespace& ns);
@@ -54,14 +100,21 @@ DLLLOCAL QoreClass* initZSocketStreamClass(QoreNamespace& ns);
 #ifdef QORE_BUILD_ZMQ_DRAFT
 DLLLOCAL QoreClass* initZSocketServerClass(QoreNamespace& ns);
 DLLLOCAL QoreClass* initZSocketClientClass(QoreNamespace& ns);
+DLLLOCAL QoreClass* initZSocketRadioClass(QoreNamespace& ns);
+DLLLOCAL QoreClass* initZSocketDishClass(QoreNamespace& ns);
 #endif
-//DLLLOCAL QoreClass* initZSocketRadioClass(QoreNamespace& ns);
-//DLLLOCAL QoreClass* initZSocketDishClass(QoreNamespace& ns);
 //DLLLOCAL QoreClass* initZSocketScatterClass(QoreNamespace& ns);
 //DLLLOCAL QoreClass* initZSocketGatherClass(QoreNamespace& ns);
 //DLLLOCAL QoreClass* initZSocketDGramClass(QoreNamespace& ns);
 DLLLOCAL QoreClass* initZFrameClass(QoreNamespace& ns);
 DLLLOCAL QoreClass* initZMsgClass(QoreNamespace& ns);
+DLLLOCAL QoreClass* initZPollerClass(QoreNamespace& ns);
+DLLLOCAL QoreClass* initZLoopClass(QoreNamespace& ns);
+DLLLOCAL QoreClass* initZProxyClass(QoreNamespace& ns);
+DLLLOCAL QoreClass* initZBrokerClass(QoreNamespace& ns);
+DLLLOCAL QoreClass* initZRpcClientClass(QoreNamespace& ns);
+DLLLOCAL QoreClass* initZMonitorClass(QoreNamespace& ns);
+DLLLOCAL QoreClass* initZJournalClass(QoreNamespace& ns);
 
 // qore module symbols
 DLLEXPORT char qore_module_name[] = "zmq";
@@ -92,6 +145,29 @@ static QoreStringNode* zmq_module_init() {
     hashdeclZmqVersionInfo = init_hashdecl_ZmqVersionInfo(zmqns);
     hashdeclZmqPollInfo = init_hashdecl_ZmqPollInfo(zmqns);
     hashdeclZmqCurveKeyInfo = init_hashdecl_ZmqCurveKeyInfo(zmqns);
+    hashdeclZmqProxyStatistics = init_hashdecl_ZmqProxyStatistics(zmqns);
+    hashdeclZmqMonitorEvent = init_hashdecl_ZmqMonitorEvent(zmqns);
+    hashdeclZmqContextOptions = init_hashdecl_ZmqContextOptions(zmqns);
+    hashdeclZmqJournalOptions = init_hashdecl_ZmqJournalOptions(zmqns);
+    hashdeclZmqSpoolOptions = init_hashdecl_ZmqSpoolOptions(zmqns);
+    hashdeclZmqSpoolInfo = init_hashdecl_ZmqSpoolInfo(zmqns);
+    hashdeclZmqCompressionInfo = init_hashdecl_ZmqCompressionInfo(zmqns);
+    hashdeclZmqLvcOptions = init_hashdecl_ZmqLvcOptions(zmqns);
+    hashdeclZmqLvcInfo = init_hashdecl_ZmqLvcInfo(zmqns);
+    hashdeclZmqConflationOptions = init_hashdecl_ZmqConflationOptions(zmqns);
+    hashdeclZmqConflationInfo = init_hashdecl_ZmqConflationInfo(zmqns);
+    hashdeclZmqBrokerOptions = init_hashdecl_ZmqBrokerOptions(zmqns);
+    hashdeclZmqBrokerStatistics = init_hashdecl_ZmqBrokerStatistics(zmqns);
+    hashdeclZmqRpcOptions = init_hashdecl_ZmqRpcOptions(zmqns);
+    hashdeclZmqRpcResult = init_hashdecl_ZmqRpcResult(zmqns);
+    hashdeclZmqRpcInfo = init_hashdecl_ZmqRpcInfo(zmqns);
+    hashdeclZmqFramerOptions = init_hashdecl_ZmqFramerOptions(zmqns);
+    hashdeclZmqFramerInfo = init_hashdecl_ZmqFramerInfo(zmqns);
+    hashdeclZmqStreamMessage = init_hashdecl_ZmqStreamMessage(zmqns);
+    hashdeclZmqSharedInfo = init_hashdecl_ZmqSharedInfo(zmqns);
+#ifdef QORE_BUILD_ZMQ_DRAFT
+    hashdeclZmqGroupMessage = init_hashdecl_ZmqGroupMessage(zmqns);
+#endif
 
     zmqns.addSystemClass(initZFrameClass(zmqns));
     zmqns.addSystemClass(initZMsgClass(zmqns));
@@ -112,12 +188,19 @@ static QoreStringNode* zmq_module_init() {
 #ifdef QORE_BUILD_ZMQ_DRAFT
     zmqns.addSystemClass(initZSocketServerClass(zmqns));
     zmqns.addSystemClass(initZSocketClientClass(zmqns));
-    //zmqns.addSystemClass(initZSocketRadioClass(zmqns));
-    //zmqns.addSystemClass(initZSocketDishClass(zmqns));
+    zmqns.addSystemClass(initZSocketRadioClass(zmqns));
+    zmqns.addSystemClass(initZSocketDishClass(zmqns));
     //zmqns.addSystemClass(initZSocketScatterClass(zmqns));
     //zmqns.addSystemClass(initZSocketGatherClass(zmqns));
     //zmqns.addSystemClass(initZSocketDGramClass(zmqns));
 #endif
+    zmqns.addSystemClass(initZPollerClass(zmqns));
+    zmqns.addSystemClass(initZLoopClass(zmqns));
+    zmqns.addSystemClass(initZProxyClass(zmqns));
+    zmqns.addSystemClass(initZBrokerClass(zmqns));
+    zmqns.addSystemClass(initZRpcClientClass(zmqns));
+    zmqns.addSystemClass(initZMonitorClass(zmqns));
+    zmqns.addSystemClass(initZJournalClass(zmqns));
 
     init_zmq_constants(zmqns);
     init_zmq_functions(zmqns);
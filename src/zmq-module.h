@@ -31,42 +31,153 @@
 
 #include <zmq.h>
 
+// zero-copy frames require zframe_frommem() from the czmq draft API
+#if defined(HAVE_ZFRAME_FROMMEM) && defined(CZMQ_BUILD_DRAFT_API)
+#define QORE_HAVE_ZFRAME_ZEROCOPY 1
+#endif
+
+// I/O thread scheduling, CPU affinity and naming context options are available in libzmq 4.3+
+#if defined(ZMQ_THREAD_SCHED_POLICY) && defined(ZMQ_THREAD_AFFINITY_CPU_ADD) && defined(ZMQ_THREAD_NAME_PREFIX)
+#define QORE_HAVE_ZMQ_THREAD_OPTIONS 1
+#endif
+
+// the STATISTICS command for steerable proxies is supported from libzmq 4.3
+#if ZMQ_VERSION >= ZMQ_MAKE_VERSION(4, 3, 0)
+#define QORE_HAVE_ZMQ_PROXY_STATISTICS 1
+#endif
+
 #include <stdarg.h>
 
+#include <atomic>
+
 DLLLOCAL void zmq_error(ExceptionSink* xsink, const char* err, const char* desc_fmt, ...);
 
 // for hashdecls
 DLLLOCAL extern const TypedHashDecl* hashdeclZmqVersionInfo;
 DLLLOCAL extern const TypedHashDecl* hashdeclZmqPollInfo;
 DLLLOCAL extern const TypedHashDecl* hashdeclZmqCurveKeyInfo;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqProxyStatistics;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqMonitorEvent;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqContextOptions;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqJournalOptions;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqSpoolOptions;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqSpoolInfo;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqCompressionInfo;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqLvcOptions;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqLvcInfo;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqConflationOptions;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqConflationInfo;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqBrokerOptions;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqBrokerStatistics;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqRpcOptions;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqRpcResult;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqRpcInfo;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqFramerOptions;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqFramerInfo;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqStreamMessage;
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqSharedInfo;
+#ifdef QORE_BUILD_ZMQ_DRAFT
+DLLLOCAL extern const TypedHashDecl* hashdeclZmqGroupMessage;
+#endif
+
+// the TID value for objects released from their owning thread and not yet adopted by another thread
+#define ZMQ_TID_RELEASED -1
 
 // base class for private data restricted to the thread in which it was created
 class AbstractZmqThreadLocalData : public AbstractPrivateData {
 public:
     DLLLOCAL int check(ExceptionSink* xsink) const {
-        if (!thread_safe && tid != q_gettid()) {
-            xsink->raiseException(getErrorString(), "this object was created in TID %d; it is an error to access " \
-                "it from any other thread (accessed from TID %d)", tid, q_gettid());
+        if (native_owned) {
+            xsink->raiseException(getErrorString(), "this object is in use by a native module thread (ex: a ZProxy " \
+                "object) and cannot be accessed from Qore (accessed from TID %d)", q_gettid());
+            return -1;
+        }
+        int t = tid.load(std::memory_order_relaxed);
+        // the acquire load makes state set up before the object was made thread-safe (ex: the lock for a socket in
+        // shared mode) visible to this thread
+        if (!thread_safe.load(std::memory_order_acquire) && t != q_gettid()) {
+            if (t == ZMQ_TID_RELEASED) {
+                xsink->raiseException(getErrorString(), "this object has been released by its owning thread; it " \
+                    "must be adopted with adopt() before it can be used (accessed from TID %d)", q_gettid());
+            } else {
+                xsink->raiseException(getErrorString(), "this object was created in TID %d; it is an error to " \
+                    "access it from any other thread (accessed from TID %d)", t, q_gettid());
+            }
             return -1;
         }
         return 0;
     }
 
     DLLLOCAL int gettid() const {
-        return tid;
+        return tid.load(std::memory_order_relaxed);
     }
 
+    // releases the object from the current thread so that it can be adopted by another thread
+    DLLLOCAL int release(ExceptionSink* xsink) {
+        if (check(xsink))
+            return -1;
+        if (isThreadSafe())
+            return 0;
+        // make all changes to the underlying ZeroMQ object made in this thread visible to the adopting thread
+        std::atomic_thread_fence(std::memory_order_release);
+        tid.store(ZMQ_TID_RELEASED, std::memory_order_release);
+        return 0;
+    }
+
+    // makes the current thread the owner of an object released by its previous owner
+    DLLLOCAL int adopt(const char* err, ExceptionSink* xsink) {
+        if (isThreadSafe())
+            return 0;
+        int me = q_gettid();
+        int t = ZMQ_TID_RELEASED;
+        if (!tid.compare_exchange_strong(t, me, std::memory_order_acq_rel)) {
+            if (t == me)
+                return 0;
+            xsink->raiseException(err, "this object is owned by TID %d; it must be released with release() in that " \
+                "thread before it can be adopted (adopt() called from TID %d)", t, me);
+            return -1;
+        }
+        // see all changes made to the underlying ZeroMQ object by the releasing thread
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return 0;
+    }
+
+    // must be called after any state needed to access the object from other threads has been set up
     DLLLOCAL void setThreadSafe() {
-        assert(!thread_safe);
-        thread_safe = true;
+        assert(!isThreadSafe());
+        thread_safe.store(true, std::memory_order_release);
+    }
+
+    DLLLOCAL bool isThreadSafe() const {
+        return thread_safe.load(std::memory_order_acquire);
+    }
+
+    // marks the object as owned by a native thread, or releases it back to the Qore thread that created it
+    DLLLOCAL void setNativeOwned(bool owned) {
+        native_owned = owned;
+    }
+
+    DLLLOCAL bool isNativeOwned() const {
+        return native_owned;
+    }
+
+    // atomically marks the object as owned by a native thread; returns false if it's already owned by one
+    DLLLOCAL bool claimNativeOwned() {
+        bool owned = false;
+        return native_owned.compare_exchange_strong(owned, true);
     }
 
     //! the error string for exceptions
     virtual const char* getErrorString() const = 0;
 
 private:
-    int tid = q_gettid();
-    bool thread_safe = false;
+    // the owning thread or ZMQ_TID_RELEASED
+    std::atomic<int> tid{q_gettid()};
+    // set for thread-safe objects; stored with release semantics after the state needed to use the object from
+    // other threads has been set up
+    std::atomic<bool> thread_safe{false};
+    // set while the object is used by a native thread that no Qore thread may interfere with
+    std::atomic<bool> native_owned{false};
 };
 
 #endif